@@ -26,6 +26,8 @@
 #include "drivers/radio/radio.h"
 #include "drivers/adc/adc.h"
 #include "drivers/buzzer/buzzer.h"
+#include "drivers/motors/motors.h"
+#include "drivers/uart/uart.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -169,20 +171,16 @@ void DebugMon_Handler(void)
 void EXTI9_5_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI9_5_IRQn 0 */
-    EXTI_HandleTypeDef hexti;
-
-    hexti.Line = EXTI_LINE_6;
-    if(HAL_EXTI_GetPending(&hexti, EXTI_TRIGGER_RISING_FALLING))
+    if(__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_6) != 0)
     {
+        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_6);
         RadioIsr(RADIO_CHANNEL_5, PWM_IN_5_GPIO_Port, PWM_IN_5_Pin);
-        HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_6);
     }
 
-    hexti.Line = EXTI_LINE_7;
-    if(HAL_EXTI_GetPending(&hexti, EXTI_TRIGGER_RISING_FALLING))
+    if(__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_7) != 0)
     {
+        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_7);
         RadioIsr(RADIO_CHANNEL_6, PWM_IN_6_GPIO_Port, PWM_IN_6_Pin);
-        HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_7);
     }
     return;
   /* USER CODE END EXTI9_5_IRQn 0 */
@@ -227,33 +225,26 @@ void TIM3_IRQHandler(void)
 void EXTI15_10_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI15_10_IRQn 0 */
-
-    EXTI_HandleTypeDef hexti;
-
-    hexti.Line = EXTI_LINE_12;
-    if(HAL_EXTI_GetPending(&hexti, EXTI_TRIGGER_RISING_FALLING))
+    if(__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_12) != 0)
     {
+        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_12);
         RadioIsr(RADIO_CHANNEL_1, PWM_IN_1_GPIO_Port, PWM_IN_1_Pin);
-        HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_12);
     }
 
-    hexti.Line = EXTI_LINE_13;
-    if(HAL_EXTI_GetPending(&hexti, EXTI_TRIGGER_RISING_FALLING))
+    if(__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_13) != 0)
     {
+        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_13);
         RadioIsr(RADIO_CHANNEL_2, PWM_IN_2_GPIO_Port, PWM_IN_2_Pin);
-        HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_13);
     }
-    hexti.Line = EXTI_LINE_14;
-    if(HAL_EXTI_GetPending(&hexti, EXTI_TRIGGER_RISING_FALLING))
+    if(__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_14) != 0)
     {
+        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_14);
         RadioIsr(RADIO_CHANNEL_3, PWM_IN_3_GPIO_Port, PWM_IN_3_Pin);
-        HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_14);
     }
-    hexti.Line = EXTI_LINE_15;
-    if(HAL_EXTI_GetPending(&hexti, EXTI_TRIGGER_RISING_FALLING))
+    if(__HAL_GPIO_EXTI_GET_IT(GPIO_PIN_15) != 0)
     {
+        __HAL_GPIO_EXTI_CLEAR_IT(GPIO_PIN_15);
         RadioIsr(RADIO_CHANNEL_4, PWM_IN_4_GPIO_Port, PWM_IN_4_Pin);
-        HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_15);
     }
     return;
   /* USER CODE END EXTI15_10_IRQn 0 */
@@ -282,5 +273,29 @@ void DMA2_Stream0_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles USART1 global interrupt, used by configuration protocol.
+  */
+void USART1_IRQHandler(void)
+{
+    UartIsr();
+}
+
+/**
+  * @brief This function handles USART6 global interrupt, used by serial radio receiver.
+  */
+void USART6_IRQHandler(void)
+{
+    RadioUartIsr();
+}
+
+/**
+  * @brief This function handles DMA2 stream5 global interrupt, used by bidirectional DShot.
+  */
+void DMA2_Stream5_IRQHandler(void)
+{
+    MotorsDmaIsr();
+}
+
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
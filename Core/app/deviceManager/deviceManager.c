@@ -12,6 +12,7 @@
 
 #include "main.h"
 #include "cmsis_os.h"
+#include "event_groups.h"
 
 #include "drivers/BMX055/BMX055.h"
 #include "drivers/LPS/LPS.h"
@@ -29,8 +30,11 @@
 #include "middleware/radioStatus/radioStatus.h"
 #include "middleware/remoteSettings/remoteSettings.h"
 #include "middleware/memory/memory.h"
+#include "middleware/parameters/parameters.h"
+#include "middleware/configProtocol/configProtocol.h"
 #include "middleware/flightController/flightController.h"
 #include "middleware/altitude/altitude.h"
+#include "middleware/motorTelemetry/motorTelemetry.h"
 
 /*****************************************************************************
                           PRIVATE DEFINES / MACROS
@@ -57,15 +61,36 @@ enum{
     INIT_LOOP_MAHONY,
     INIT_LOOP_MOTORS,
     INIT_LOOP_REMOTE_SETTINGS,
-    INIT_LOOP_FLIGHT_CONTROL
+    INIT_LOOP_FLIGHT_CONTROL,
+    INIT_LOOP_RADIO,
+    INIT_LOOP_TASKS,
+    INIT_LOOP_SOUND
 };
 
+/** task stack sizes in words **/
+#define SOUND_NOTIFICATION_TASK_STACK_SIZE (200U)
+#define RADIO_STATUS_TASK_STACK_SIZE       (200U)
+#define REMOTE_SETTINGS_TASK_STACK_SIZE    (200U)
+#define BATTERY_STATUS_TASK_STACK_SIZE     (200U)
+#define MAHONY_FILTER_TASK_STACK_SIZE      (500U)
+#define ALTITUDE_TASK_STACK_SIZE           (200U)
+#define IMU_CALIBRATION_TASK_STACK_SIZE    (1000U)
+#define DEVICE_MANAGER_TASK_STACK_SIZE     (200U)
+#define FLIGHT_CONTROLLER_TASK_STACK_SIZE  (300U)
+#define MEMORY_TASK_STACK_SIZE             (200U)
+#define CONFIG_PROTOCOL_TASK_STACK_SIZE    (300U)
 
 
-#define THROTTLE_OFF_TRH (0.05f)
-#define SWITCH_OFF_TRH (0.25f)
-#define FLIGHT_MODE_ZEROS_MAX_COUNT (10U)
-#define HOMING_COUNTER_MAX_COUNT (10U)
+
+#define DEVICE_MANAGER_TIMEOUT_MS (100U)   ///< [ms] max time between state machine evaluations
+#define DISARM_DELAY_MS (500U)              ///< [ms] throttle needs to be off this long to disarm in flight
+#define HOMING_RECOVERY_DELAY_MS (1000U)    ///< [ms] radio needs to be back this long to leave homing
+
+/** internal events, not posted by other modules **/
+#define DM_EVENT_STATE_ENTRY (0x1000U)      ///< operating mode has just changed
+#define DM_EVENT_TIMEOUT     (0x2000U)      ///< state machine woke up, used for timers
+
+#define DM_EXTERNAL_EVENTS (0x3FFU)         ///< all deviceManagerEvent_t bits
 
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
@@ -73,6 +98,29 @@ enum{
 
 static deviceOperatingModes_t operatingMode = DEVICE_INITIALIZATION;
 
+/**@brief single state machine transition
+ *        transition is taken when current mode equals mode,
+ *        any of events has occurred and guard returns true
+ *        if nextMode equals mode only action is executed and
+ *        next transitions are checked
+ */
+typedef struct{
+    deviceOperatingModes_t mode;
+    uint32_t events;
+    bool (*guard)(void);
+    void (*action)(void);
+    deviceOperatingModes_t nextMode;
+}transition_t;
+
+static StaticEventGroup_t eventGroupBuffer;
+static EventGroupHandle_t eventGroup = NULL;
+
+static TickType_t throttleOffTime = 0;
+static bool throttleOffTimerRunning = false;
+
+static TickType_t radioRestoredTime = 0;
+static bool radioRestoredTimerRunning = false;
+
 static struct{
     TaskHandle_t soundNotificationTask;
     TaskHandle_t radioStatusTask;
@@ -83,8 +131,40 @@ static struct{
     TaskHandle_t imuCalibrationTask;
     TaskHandle_t deviceManagerTask;
     TaskHandle_t flightControllerTask;
+    TaskHandle_t memoryTask;
+    TaskHandle_t configProtocolTask;
 }taskHandles;
 
+/** statically allocated task stacks, same layout as taskHandles **/
+static struct{
+    StackType_t soundNotificationTask[SOUND_NOTIFICATION_TASK_STACK_SIZE];
+    StackType_t radioStatusTask      [RADIO_STATUS_TASK_STACK_SIZE      ];
+    StackType_t remoteSettingsTask   [REMOTE_SETTINGS_TASK_STACK_SIZE   ];
+    StackType_t batteryStatusTask    [BATTERY_STATUS_TASK_STACK_SIZE    ];
+    StackType_t mahonyFilterTask     [MAHONY_FILTER_TASK_STACK_SIZE     ];
+    StackType_t altitudeTask         [ALTITUDE_TASK_STACK_SIZE          ];
+    StackType_t imuCalibrationTask   [IMU_CALIBRATION_TASK_STACK_SIZE   ];
+    StackType_t deviceManagerTask    [DEVICE_MANAGER_TASK_STACK_SIZE    ];
+    StackType_t flightControllerTask [FLIGHT_CONTROLLER_TASK_STACK_SIZE ];
+    StackType_t memoryTask           [MEMORY_TASK_STACK_SIZE            ];
+    StackType_t configProtocolTask   [CONFIG_PROTOCOL_TASK_STACK_SIZE   ];
+}taskStacks;
+
+/** statically allocated task control blocks, same layout as taskHandles **/
+static struct{
+    StaticTask_t soundNotificationTask;
+    StaticTask_t radioStatusTask;
+    StaticTask_t remoteSettingsTask;
+    StaticTask_t batteryStatusTask;
+    StaticTask_t mahonyFilterTask;
+    StaticTask_t altitudeTask;
+    StaticTask_t imuCalibrationTask;
+    StaticTask_t deviceManagerTask;
+    StaticTask_t flightControllerTask;
+    StaticTask_t memoryTask;
+    StaticTask_t configProtocolTask;
+}taskBuffers;
+
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
@@ -94,6 +174,75 @@ static struct{
  */
 static void DeviceManagerTask();
 
+/**@brief evaluates transition table for current operating mode
+ *
+ * @param [in] events - events that occurred since last evaluation
+ * @return DM_EVENT_STATE_ENTRY if operating mode has changed, 0 otherwise
+ */
+static uint32_t ProcessEvents(uint32_t events);
+
+/** TRANSITION GUARDS **/
+static bool BatteryNotOk();
+static bool ThrottleOn();
+static bool ArmAllowed();
+static bool ThrottleOff();
+static bool SwitchOn();
+static bool SwitchOffCalibrationRequested();
+static bool SwitchOff();
+static bool ThrottleOffManual();
+static bool FailsafeRequired();
+static bool DisarmDelayElapsed();
+static bool RadioRestored();
+static bool HomingRecoveryDelayElapsed();
+
+/** TRANSITION ACTIONS **/
+static void ClearCalibrationRequest();
+static void Arm();
+static void StartCalibration();
+static void SaveSettings();
+static void FinishCalibration();
+static void StartDisarmTimer();
+static void Disarm();
+static void StartHomingRecoveryTimer();
+static void ReportMotorFailure();
+
+/**@brief writes battery estimate to debug uart
+ */
+static void ReportBattery();
+
+/**@brief writes PID calculation cycles of last flight to debug uart
+ */
+static void ReportPidCycles();
+
+/**@brief writes stick to motor latency of last flight to debug uart
+ */
+static void ReportStickLatency();
+
+/**@brief reads motors protocol from remote settings
+ *
+ * @return stored protocol, MOTORS_PROTOCOL if stored value is invalid
+ */
+static motorsProtocol_t GetMotorsProtocol();
+
+/**@brief creates task using statically allocated stack and control block
+ *
+ * @param [in] taskFunction
+ * @param [in] name
+ * @param [in] stackSize - size of @param stack in words
+ * @param [in] priority
+ * @param [in] stack - stack buffer
+ * @param [in] taskBuffer - task control block buffer
+ * @param [out] taskHandle
+ * @return true if successful
+ */
+static bool CreateStaticTask(TaskFunction_t taskFunction,
+                             const char* name,
+                             uint32_t stackSize,
+                             UBaseType_t priority,
+                             StackType_t* stack,
+                             StaticTask_t* taskBuffer,
+                             TaskHandle_t* taskHandle);
+
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
 *****************************************************************************/
@@ -122,11 +271,19 @@ void DeviceManagerInit(ADC_HandleTypeDef* adcHandle,
     {
         INITIALIZATION_FAIL_LOOP(INIT_LOOP_UART)
     }
+    if(!SoundNotificationsInit())
+    {
+        INITIALIZATION_FAIL_LOOP(INIT_LOOP_SOUND)
+    }
     if(!EepromInit())
     {
         INITIALIZATION_FAIL_LOOP(INIT_LOOP_EEPROM)
     }
     MemoryInit();
+    if(!ParametersInit())
+    {
+        INITIALIZATION_FAIL_LOOP(INIT_LOOP_EEPROM)
+    }
     if(!Bmx055Init(spiBMXHandle))
     {
         INITIALIZATION_FAIL_LOOP(INIT_LOOP_BMX)
@@ -139,6 +296,10 @@ void DeviceManagerInit(ADC_HandleTypeDef* adcHandle,
     {
         INITIALIZATION_FAIL_LOOP(INIT_LOOP_ADC)
     }
+    if(!RadioInit())
+    {
+        INITIALIZATION_FAIL_LOOP(INIT_LOOP_RADIO)
+    }
     if(!AltitudeInit())
     {
         INITIALIZATION_FAIL_LOOP(INIT_LOOP_ALTITUDE)
@@ -147,30 +308,45 @@ void DeviceManagerInit(ADC_HandleTypeDef* adcHandle,
     {
         INITIALIZATION_FAIL_LOOP(INIT_LOOP_MAHONY)
     }
-    if(!MotorsInit(timMotorsHandle))
-    {
-        INITIALIZATION_FAIL_LOOP(INIT_LOOP_MOTORS)
-    }
     if(!RemoteSettingsInit())
     {
         INITIALIZATION_FAIL_LOOP(INIT_LOOP_REMOTE_SETTINGS)
     }
+    if(!MotorsInit(timMotorsHandle, GetMotorsProtocol()))
+    {
+        INITIALIZATION_FAIL_LOOP(INIT_LOOP_MOTORS)
+    }
     if(!FlightControllerInit())
     {
         INITIALIZATION_FAIL_LOOP(INIT_LOOP_FLIGHT_CONTROL)
     }
 
+    eventGroup = xEventGroupCreateStatic(&eventGroupBuffer);
+
     /** CREATE TASKS **/
 
-    xTaskCreate(&SoundNotificationTask, "soundNotificationTask", 200,  NULL, 0, &(taskHandles.soundNotificationTask));
-    xTaskCreate(&RadioStatusTask,       "radioStatusTask",       200,  NULL, 0, &(taskHandles.radioStatusTask      ));
-    xTaskCreate(&RemoteSettingsTask,    "remoteSettingsTask",    200,  NULL, 0, &(taskHandles.remoteSettingsTask   ));
-    xTaskCreate(&BatteryStatusTask,     "batteryStatusTask",     200,  NULL, 0, &(taskHandles.batteryStatusTask    ));
-    xTaskCreate(&MahonyFilterTask,      "mahonyFilterTask",      500,  NULL, 1, &(taskHandles.mahonyFilterTask     ));
-    xTaskCreate(&AltitudeTask,          "altitudeTask",          200,  NULL, 0, &(taskHandles.altitudeTask         ));
-    xTaskCreate(&ImuCalibrationTask,    "imuCalibrationTask",    1000, NULL, 0, &(taskHandles.imuCalibrationTask   ));
-    xTaskCreate(&DeviceManagerTask,     "deviceManagerTask",     200,  NULL, 0, &(taskHandles.deviceManagerTask    ));
-    xTaskCreate(&FlightControllerTask,  "flightControllerTask",  300,  NULL, 0, &(taskHandles.flightControllerTask ));
+    bool tasksCreated = true;
+
+    tasksCreated &= CreateStaticTask(&SoundNotificationTask, "soundNotificationTask", SOUND_NOTIFICATION_TASK_STACK_SIZE, 0, taskStacks.soundNotificationTask, &(taskBuffers.soundNotificationTask), &(taskHandles.soundNotificationTask));
+    tasksCreated &= CreateStaticTask(&RadioStatusTask,       "radioStatusTask",       RADIO_STATUS_TASK_STACK_SIZE,       0, taskStacks.radioStatusTask,       &(taskBuffers.radioStatusTask      ), &(taskHandles.radioStatusTask      ));
+    tasksCreated &= CreateStaticTask(&RemoteSettingsTask,    "remoteSettingsTask",    REMOTE_SETTINGS_TASK_STACK_SIZE,    0, taskStacks.remoteSettingsTask,    &(taskBuffers.remoteSettingsTask   ), &(taskHandles.remoteSettingsTask   ));
+    tasksCreated &= CreateStaticTask(&BatteryStatusTask,     "batteryStatusTask",     BATTERY_STATUS_TASK_STACK_SIZE,     0, taskStacks.batteryStatusTask,     &(taskBuffers.batteryStatusTask    ), &(taskHandles.batteryStatusTask    ));
+    tasksCreated &= CreateStaticTask(&MahonyFilterTask,      "mahonyFilterTask",      MAHONY_FILTER_TASK_STACK_SIZE,      1, taskStacks.mahonyFilterTask,      &(taskBuffers.mahonyFilterTask     ), &(taskHandles.mahonyFilterTask     ));
+    tasksCreated &= CreateStaticTask(&AltitudeTask,          "altitudeTask",          ALTITUDE_TASK_STACK_SIZE,           0, taskStacks.altitudeTask,          &(taskBuffers.altitudeTask         ), &(taskHandles.altitudeTask         ));
+    tasksCreated &= CreateStaticTask(&ImuCalibrationTask,    "imuCalibrationTask",    IMU_CALIBRATION_TASK_STACK_SIZE,    0, taskStacks.imuCalibrationTask,    &(taskBuffers.imuCalibrationTask   ), &(taskHandles.imuCalibrationTask   ));
+    tasksCreated &= CreateStaticTask(&DeviceManagerTask,     "deviceManagerTask",     DEVICE_MANAGER_TASK_STACK_SIZE,     0, taskStacks.deviceManagerTask,     &(taskBuffers.deviceManagerTask    ), &(taskHandles.deviceManagerTask    ));
+    tasksCreated &= CreateStaticTask(&FlightControllerTask,  "flightControllerTask",  FLIGHT_CONTROLLER_TASK_STACK_SIZE,  0, taskStacks.flightControllerTask,  &(taskBuffers.flightControllerTask ), &(taskHandles.flightControllerTask ));
+    tasksCreated &= CreateStaticTask(&MemoryTask,            "memoryTask",            MEMORY_TASK_STACK_SIZE,             0, taskStacks.memoryTask,            &(taskBuffers.memoryTask           ), &(taskHandles.memoryTask           ));
+    tasksCreated &= CreateStaticTask(&ConfigProtocolTask,    "configProtocolTask",    CONFIG_PROTOCOL_TASK_STACK_SIZE,    0, taskStacks.configProtocolTask,    &(taskBuffers.configProtocolTask   ), &(taskHandles.configProtocolTask   ));
+
+    if(!tasksCreated)
+    {
+        INITIALIZATION_FAIL_LOOP(INIT_LOOP_TASKS)
+    }
+
+    UartWrite("static task and queue RAM: %u B, free heap: %u B\r\n",
+              (uint32_t)(sizeof(taskStacks)+sizeof(taskBuffers)+sizeof(eventGroupBuffer)+SoundNotificationsGetStaticRamSize()),
+              (uint32_t)xPortGetFreeHeapSize());
 
     operatingMode = DEVICE_STANDBY;
 
@@ -181,188 +357,310 @@ deviceOperatingModes_t DeviceManagerGetOperatingMode()
     return operatingMode;
 }
 
+void DeviceManagerPostEvent(deviceManagerEvent_t event)
+{
+    if(eventGroup == NULL)
+    {
+        return;
+    }
+
+    xEventGroupSetBits(eventGroup, ((uint32_t)event)&DM_EXTERNAL_EVENTS);
+}
+
 /******************************************************************************
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
 
+/**@brief device manager transition table,
+ *        for each mode transitions are checked from top to bottom,
+ *        failsafe is also checked as level condition on every wakeup, so a missed edge event cannot keep flight mode
+ */
+static const transition_t transitions[] = {
+    /** STANDBY MODE **/
+    {DEVICE_STANDBY,     DM_EVENT_BATTERY_CHANGED|DM_EVENT_STATE_ENTRY,                     &BatteryNotOk,                  &ClearCalibrationRequest,  DEVICE_ERROR      },
+    {DEVICE_STANDBY,     DM_EVENT_THROTTLE_HIGH|DM_EVENT_STATE_ENTRY|DM_EVENT_TIMEOUT,      &ArmAllowed,                    &Arm,                      DEVICE_FLIGHT     },
+    {DEVICE_STANDBY,     DM_EVENT_SWITCH_ON|DM_EVENT_STATE_ENTRY,                           &SwitchOn,                      NULL,                      DEVICE_SETTINGS   },
+
+    /** SETTINGS_MODE **/
+    {DEVICE_SETTINGS,    DM_EVENT_SWITCH_OFF|DM_EVENT_STATE_ENTRY,                          &SwitchOffCalibrationRequested, &StartCalibration,         DEVICE_CALIBRATION},
+    {DEVICE_SETTINGS,    DM_EVENT_SWITCH_OFF|DM_EVENT_STATE_ENTRY,                          &SwitchOff,                     &SaveSettings,             DEVICE_STANDBY    },
+    {DEVICE_SETTINGS,    DM_EVENT_BATTERY_CHANGED|DM_EVENT_STATE_ENTRY,                     &BatteryNotOk,                  &ClearCalibrationRequest,  DEVICE_ERROR      },
+
+    /** CALIBRATION MODE **/
+    {DEVICE_CALIBRATION, DM_EVENT_CALIBRATION_DONE,                                         NULL,                           &FinishCalibration,        DEVICE_STANDBY    },
+    {DEVICE_CALIBRATION, DM_EVENT_SWITCH_ON|DM_EVENT_STATE_ENTRY,                           &SwitchOn,                      &ClearCalibrationRequest,  DEVICE_SETTINGS   },
+    {DEVICE_CALIBRATION, DM_EVENT_BATTERY_CHANGED|DM_EVENT_STATE_ENTRY,                     &BatteryNotOk,                  &ClearCalibrationRequest,  DEVICE_ERROR      },
+
+    /** FLIGHT MODE **/
+    {DEVICE_FLIGHT,      DM_EVENT_MOTOR_FAILURE,                                            NULL,                           &ReportMotorFailure,       DEVICE_FLIGHT     },
+    {DEVICE_FLIGHT,      DM_EVENT_RADIO_LOST|DM_EVENT_BATTERY_CHANGED|DM_EVENT_STATE_ENTRY, &FailsafeRequired,              NULL,                      DEVICE_HOMING     },
+    {DEVICE_FLIGHT,      DM_EVENT_TIMEOUT,                                                  &FailsafeRequired,              NULL,                      DEVICE_HOMING     },
+    {DEVICE_FLIGHT,      DM_EVENT_THROTTLE_LOW|DM_EVENT_SWITCH_OFF|DM_EVENT_STATE_ENTRY,    &ThrottleOffManual,             &StartDisarmTimer,         DEVICE_FLIGHT     },
+    {DEVICE_FLIGHT,      DM_EVENT_TIMEOUT,                                                  &DisarmDelayElapsed,            &Disarm,                   DEVICE_STANDBY    },
+
+    /** HOMING MODE **/
+    {DEVICE_HOMING,      DM_EVENT_LANDED,                                                   NULL,                           &Disarm,                   DEVICE_STANDBY    },
+    {DEVICE_HOMING,      DM_EVENT_MOTOR_FAILURE,                                            NULL,                           &ReportMotorFailure,       DEVICE_HOMING     },
+    {DEVICE_HOMING,      DM_EVENT_RADIO_RESTORED|DM_EVENT_STATE_ENTRY,                      &RadioRestored,                 &StartHomingRecoveryTimer, DEVICE_HOMING     },
+    {DEVICE_HOMING,      DM_EVENT_TIMEOUT,                                                  &HomingRecoveryDelayElapsed,    NULL,                      DEVICE_FLIGHT     },
+};
+
 static void DeviceManagerTask()
 {
+    uint32_t events = DM_EVENT_STATE_ENTRY;
+
     while(1)
     {
-        /** STANDBY MODE **/
-        if(operatingMode == DEVICE_STANDBY)
+        if(events == 0)
         {
-            if(BatteryStatusGetStatus() != BATTERY_OK)
-            {
-                RemoteSettingsSetVariable(RS_CALIBRATION, 0.0f);
-                operatingMode = DEVICE_ERROR;
-                continue;
-            }
-
-            if(RadioStatusGetChannelData(RADIO_THROTTLE_CHANNEL) > THROTTLE_OFF_TRH)
-            {
-                operatingMode = DEVICE_FLIGHT;
-                AltitudeSetHome();
-                vTaskResume(taskHandles.flightControllerTask);
-                continue;
-            }
-
-            if(RadioStatusGetChannelData(RADIO_SWITCH_CHANNEL) > SWITCH_OFF_TRH)
-            {
-                operatingMode = DEVICE_SETTINGS;
-                continue;
-            }
+            events = xEventGroupWaitBits(eventGroup,
+                                         DM_EXTERNAL_EVENTS,
+                                         pdTRUE,
+                                         pdFALSE,
+                                         pdMS_TO_TICKS(DEVICE_MANAGER_TIMEOUT_MS));
+            events &= DM_EXTERNAL_EVENTS;
         }
 
-        /** SETTINGS_MODE **/
-        if(operatingMode == DEVICE_SETTINGS)
+        events = ProcessEvents(events|DM_EVENT_TIMEOUT);
+    }
+}
+
+static uint32_t ProcessEvents(uint32_t events)
+{
+    for(uint32_t i=0; i<sizeof(transitions)/sizeof(transitions[0]); i++)
+    {
+        if(transitions[i].mode != operatingMode ||
+           (transitions[i].events&events) == 0)
         {
-            float calibration = 0;
-            RemoteSettingsGetVariable(RS_CALIBRATION, &calibration);
-            if(RadioStatusGetChannelData(RADIO_SWITCH_CHANNEL) < SWITCH_OFF_TRH)
-            {
-                if(calibration<-1 || calibration>1)
-                {
-                    operatingMode = DEVICE_CALIBRATION;
-                    vTaskResume(taskHandles.imuCalibrationTask);
-
-                    continue;
-                } else  {
-                    MemorySaveRegisteredVariables();
-                    operatingMode = DEVICE_STANDBY;
-                    continue;
-                }
-
-            }
-
-            if(BatteryStatusGetStatus() != BATTERY_OK)
-            {
-                RemoteSettingsSetVariable(RS_CALIBRATION, 0.0f);
-                operatingMode = DEVICE_ERROR;
-                continue;
-            }
+            continue;
         }
 
-        /** CALIBRATION MODE **/
-        if(operatingMode == DEVICE_CALIBRATION)
+        if(transitions[i].guard != NULL && !transitions[i].guard())
         {
-            if(eSuspended == eTaskGetState(taskHandles.imuCalibrationTask))
-            {
-                RemoteSettingsSetVariable(RS_CALIBRATION, 0.0f);
-                operatingMode = DEVICE_STANDBY;
-                MemorySaveRegisteredVariables();
-                continue;
-            }
-
-            if(RadioStatusGetChannelData(RADIO_SWITCH_CHANNEL) > SWITCH_OFF_TRH)
-            {
-                RemoteSettingsSetVariable(RS_CALIBRATION, 0.0f);
-                operatingMode = DEVICE_SETTINGS;
-                continue;
-            }
-
-            if(BatteryStatusGetStatus() != BATTERY_OK)
-            {
-                RemoteSettingsSetVariable(RS_CALIBRATION, 0.0f);
-                operatingMode = DEVICE_ERROR;
-                continue;
-            }
+            continue;
         }
 
-        /** FLIGHT MODE **/
-        if(operatingMode == DEVICE_FLIGHT)
+        if(transitions[i].action != NULL)
         {
-            static uint16_t flightModeZerosCounter = 0;
-
-            if(RadioStatusGetChannelData(RADIO_THROTTLE_CHANNEL) < THROTTLE_OFF_TRH)
-            {
-                if(flightModeZerosCounter++ >= FLIGHT_MODE_ZEROS_MAX_COUNT)
-                {
-                    flightModeZerosCounter = 0;
-                    MotorsSet(MOTORS_FRONT_RIGHT,  0);
-                    MotorsSet(MOTORS_FRONT_LEFT ,  0);
-                    MotorsSet(MOTORS_BACK_LEFT  ,  0);
-                    MotorsSet(MOTORS_BACK_RIGHT ,  0);
-                    operatingMode = DEVICE_STANDBY;
-                    continue;
-                }
-            } else {
-                flightModeZerosCounter = 0;
-            }
-
-            if((!RadioStatusGetConnectionStatus()) || (BatteryStatusGetStatus() != BATTERY_OK))
-            {
-                flightModeZerosCounter = 0;
-                operatingMode = DEVICE_HOMING;
-                continue;
-            }
-
+            transitions[i].action();
         }
 
-        /**HOMING MODE **/
-        if(operatingMode == DEVICE_HOMING)
+        if(transitions[i].nextMode != operatingMode)
         {
-            static uint16_t homingCounter = 0;
-
-            if(0)       ///< check if device reached home position
-            {
-                homingCounter = 0;
-                MotorsSet(MOTORS_FRONT_RIGHT,  0);
-                MotorsSet(MOTORS_FRONT_LEFT ,  0);
-                MotorsSet(MOTORS_BACK_LEFT  ,  0);
-                MotorsSet(MOTORS_BACK_RIGHT ,  0);
-                operatingMode = DEVICE_STANDBY;
-                continue;
-            }
-
-            if(RadioStatusGetConnectionStatus())
-            {
-                if(homingCounter++ >= HOMING_COUNTER_MAX_COUNT)
-                {
-                    homingCounter = 0;
-                    operatingMode = DEVICE_FLIGHT;
-                    continue;
-                }
-            } else {
-                homingCounter = 0;
-            }
+            operatingMode = transitions[i].nextMode;
+            return DM_EVENT_STATE_ENTRY;
         }
+    }
 
+    return 0;
+}
 
+static bool BatteryNotOk()
+{
+    return BatteryStatusGetStatus() != BATTERY_OK;
+}
 
+static bool ThrottleOn()
+{
+    return RadioStatusGetChannelData(RADIO_THROTTLE_CHANNEL) > DEVICE_MANAGER_THROTTLE_OFF_TRH;
+}
 
+static bool ArmAllowed()
+{
+    /** flash erase in progress would stall control loop right after arming, retried on next wakeup **/
+    return ThrottleOn() && !MemoryEraseInProgress();
+}
 
+static bool ThrottleOff()
+{
+    return RadioStatusGetChannelData(RADIO_THROTTLE_CHANNEL) < DEVICE_MANAGER_THROTTLE_OFF_TRH;
+}
 
-/*static const char* modes[] = {
-                "DEVICE_INITIALIZATION",  /// 0
-                "DEVICE_STANDBY",         /// 1
-                "DEVICE_CALIBRATION",     /// 2
-                "DEVICE_SETTINGS",        /// 3
-                "DEVICE_FLIGHT",          /// 4
-                "DEVICE_HOMING",          /// 5
-                "DEVICE_ERROR"
-        };
+static bool SwitchOn()
+{
+    return RadioStatusGetChannelData(RADIO_SWITCH_CHANNEL) > DEVICE_MANAGER_SWITCH_OFF_TRH;
+}
 
-        UartWrite(modes[operatingMode]);
-        UartWrite(" %f\r\n",RadioStatusGetChannelData(RADIO_SWITCH_CHANNEL));*/
-/*
-       quaternion_t q = MahonyFilterGetOrientation();
-        vector_t v = QuatTranslateToRotationVector(q);
-        UartWrite("%f\t%f\t%f\r\n",v.x*180/3.141,v.y*180/3.141,v.z*180/3.141);*/
-        //UartWrite("%f\t%f\r\n",v.x*180/3.141,v.y*180/3.141);
-        //UartWrite("%f\t%f\t%f\t%f\r\n",q.w,q.i,q.j,q.k);
-/*
-        bmx055Data_t imuData;
-        Bmx055GetData(&imuData);
-/*
-        UartWrite("%f\t %f\t\r\n",atan2(imuData.ay,-imuData.az)*180/M_PI,
-                                  atan2(-imuData.ax,-imuData.az)*180/M_PI);*/
-        /*UartWrite("%f\t %f\t %f\t\r\n",imuData.gx,
-                                       imuData.gy,
-                                       imuData.gz);*/
+static bool SwitchOff()
+{
+    return RadioStatusGetChannelData(RADIO_SWITCH_CHANNEL) < DEVICE_MANAGER_SWITCH_OFF_TRH;
+}
 
+static bool SwitchOffCalibrationRequested()
+{
+    float calibration = PARAMETERS_GET(CALIBRATION);
+
+    return SwitchOff() && (calibration<-1 || calibration>1);
+}
 
-        osDelay(100);
+static bool FailsafeRequired()
+{
+    return (!RadioStatusGetConnectionStatus()) || BatteryNotOk();
+}
+
+static bool ThrottleOffManual()
+{
+    return ThrottleOff() && SwitchOff();
+}
+
+static bool DisarmDelayElapsed()
+{
+    if(!ThrottleOffManual())
+    {
+        throttleOffTimerRunning = false;
+        return false;
+    }
+
+    return throttleOffTimerRunning &&
+           (xTaskGetTickCount()-throttleOffTime) >= pdMS_TO_TICKS(DISARM_DELAY_MS);
+}
+
+static bool RadioRestored()
+{
+    return RadioStatusGetConnectionStatus();
+}
+
+static bool HomingRecoveryDelayElapsed()
+{
+    if(!RadioStatusGetConnectionStatus() || BatteryNotOk())
+    {
+        radioRestoredTimerRunning = false;
+        return false;
+    }
+
+    return radioRestoredTimerRunning &&
+           (xTaskGetTickCount()-radioRestoredTime) >= pdMS_TO_TICKS(HOMING_RECOVERY_DELAY_MS);
+}
+
+static void ClearCalibrationRequest()
+{
+    ParametersSet(PARAMETER_CALIBRATION, 0.0f);
+}
+
+static void Arm()
+{
+    /** erase could start between guard and action, blocking waits for it **/
+    MemoryBlockErase();
+    throttleOffTimerRunning = false;
+    AltitudeSetHome();
+    ReportBattery();
+    vTaskResume(taskHandles.flightControllerTask);
+}
+
+static void StartCalibration()
+{
+    vTaskResume(taskHandles.imuCalibrationTask);
+}
+
+static void SaveSettings()
+{
+    MemorySaveRegisteredVariables();
+}
+
+static void FinishCalibration()
+{
+    ClearCalibrationRequest();
+    MemorySaveRegisteredVariables();
+}
+
+static void StartDisarmTimer()
+{
+    if(!throttleOffTimerRunning)
+    {
+        throttleOffTime = xTaskGetTickCount();
+        throttleOffTimerRunning = true;
     }
 }
 
+static void Disarm()
+{
+    float power[MOTORS_COUNT] = {0};
+
+    throttleOffTimerRunning = false;
+    MotorsSetAll(power);
+    MemoryUnblockErase();
+    ReportBattery();
+    ReportPidCycles();
+    ReportStickLatency();
+}
+
+static void StartHomingRecoveryTimer()
+{
+    if(!radioRestoredTimerRunning)
+    {
+        radioRestoredTime = xTaskGetTickCount();
+        radioRestoredTimerRunning = true;
+    }
+}
+
+static void ReportMotorFailure()
+{
+    /** losing a motor on quad cannot be recovered by changing mode, pilot decides **/
+    UartWrite("motor failure, failed motors mask: 0x%x\r\n", (uint32_t)MotorTelemetryGetFailedMotors());
+    SoundNotificationsPlay(SN_MOTOR_FAILURE);
+}
+
+static void ReportBattery()
+{
+    batteryEstimate_t estimate;
+    if(!BatteryStatusGetEstimate(&estimate))
+    {
+        return;
+    }
+
+    UartWrite("battery: %u%%, %u mAh left, %i s flight time, %u mOhm\r\n",
+              (uint32_t)(estimate.stateOfCharge*100.0f),
+              (uint32_t)(estimate.remainingCapacity*1000.0f),
+              (int32_t)estimate.flightTime,
+              (uint32_t)(estimate.internalResistance*1000.0f));
+}
+
+static void ReportPidCycles()
+{
+    uint32_t bankCycles;
+    uint32_t baselineCycles;
+    if(!FlightControllerGetPidCycles(&bankCycles, &baselineCycles))
+    {
+        return;
+    }
+
+    UartWrite("pid: bank %u cycles, baseline %u cycles\r\n", bankCycles, baselineCycles);
+}
+
+static void ReportStickLatency()
+{
+    float latency;
+    float maxLatency;
+    if(!FlightControllerGetStickLatency(&latency, &maxLatency))
+    {
+        return;
+    }
+
+    UartWrite("stick latency: last %u us, max %u us\r\n",
+              (uint32_t)(latency*1000000.0f),
+              (uint32_t)(maxLatency*1000000.0f));
+}
+
+static motorsProtocol_t GetMotorsProtocol()
+{
+    float protocol = PARAMETERS_GET(ESC_PROTOCOL)+0.5f;
+    if(protocol < 0 || protocol >= MOTORS_PROTOCOL_COUNT)
+    {
+        return MOTORS_PROTOCOL;
+    }
+
+    return (motorsProtocol_t)protocol;
+}
+
+static bool CreateStaticTask(TaskFunction_t taskFunction,
+                             const char* name,
+                             uint32_t stackSize,
+                             UBaseType_t priority,
+                             StackType_t* stack,
+                             StaticTask_t* taskBuffer,
+                             TaskHandle_t* taskHandle)
+{
+    *taskHandle = xTaskCreateStatic(taskFunction, name, stackSize, NULL, priority, stack, taskBuffer);
+
+    return *taskHandle != NULL;
+}
@@ -27,6 +27,24 @@ typedef enum{
     DEVICE_ERROR
 }deviceOperatingModes_t;
 
+/**@brief events driving device manager state machine, can be or'ed together
+ */
+typedef enum{
+    DM_EVENT_RADIO_LOST       = 0x01,   ///< radio connection was lost
+    DM_EVENT_RADIO_RESTORED   = 0x02,   ///< radio connection was restored
+    DM_EVENT_THROTTLE_LOW     = 0x04,   ///< throttle went bellow DEVICE_MANAGER_THROTTLE_OFF_TRH
+    DM_EVENT_THROTTLE_HIGH    = 0x08,   ///< throttle went above DEVICE_MANAGER_THROTTLE_OFF_TRH
+    DM_EVENT_SWITCH_OFF       = 0x10,   ///< switch went bellow DEVICE_MANAGER_SWITCH_OFF_TRH
+    DM_EVENT_SWITCH_ON        = 0x20,   ///< switch went above DEVICE_MANAGER_SWITCH_OFF_TRH
+    DM_EVENT_BATTERY_CHANGED  = 0x40,   ///< battery status has changed
+    DM_EVENT_CALIBRATION_DONE = 0x80,   ///< imu calibration task finished or was aborted
+    DM_EVENT_MOTOR_FAILURE    = 0x100,  ///< motor telemetry detected new failing motor
+    DM_EVENT_LANDED           = 0x200,  ///< auto land detected touchdown and stopped motors
+}deviceManagerEvent_t;
+
+#define DEVICE_MANAGER_THROTTLE_OFF_TRH (0.05f)  ///< throttle bellow this value is treated as off
+#define DEVICE_MANAGER_SWITCH_OFF_TRH (0.25f)    ///< switch bellow this value is treated as off
+
 /*****************************************************************************
                          PUBLIC INTERFACE DECLARATION
 *****************************************************************************/
@@ -51,3 +69,11 @@ void DeviceManagerInit(ADC_HandleTypeDef* adcHandle,
  * @return current device operating mode
  */
 deviceOperatingModes_t DeviceManagerGetOperatingMode();
+
+/**@brief notifies device manager about an event,
+ *        state machine reacts to it without waiting for its next cycle
+ *        can be called only from task context
+ *
+ * @param [in] event - one or more deviceManagerEvent_t or'ed together
+ */
+void DeviceManagerPostEvent(deviceManagerEvent_t event);
@@ -11,9 +11,8 @@
 
 #include "drivers/uart/uart.h"
 #include "drivers/utils/utils.h"
-#include "drivers/eeprom/eeprom.h"
 
-#include "middleware/memory/memory.h"
+#include "middleware/parameters/parameters.h"
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -241,17 +240,7 @@ static bmxParam_t bmxParams[MODULE_COUNT] = {
         {CS_MAG_Pin,CS_MAG_GPIO_Port,MAG_MIN_ADDRESS,MAG_MAX_ADDRESS}};
 
 
-static float accXOffset = 0;
-static float accYOffset = 0;
-static float accZOffset = 0;
-
-static float gyroXOffset = 0;
-static float gyroYOffset = 0;
-static float gyroZOffset = 0;
-
-static float magXOffset = 0;
-static float magYOffset = 0;
-static float magZOffset = 0;
+/** acc, gyro and mag offsets are persistent parameters, see parameterTable.h **/
 static float magXScale = 1;
 static float magYScale = 1;
 static float magZScale = 1;
@@ -275,8 +264,6 @@ static bool SetGyroRange(uint8_t range);
 
 static bool CheckConnection();
 
-static bool NvmInit();
-
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
 *****************************************************************************/
@@ -350,10 +337,6 @@ bool Bmx055Init(SPI_HandleTypeDef *HSPI)
         return false;
     }
 
-    if(!NvmInit())
-    {
-        return false;
-    }
 /*
 
     uint8_t data[0x3E];
@@ -379,9 +362,9 @@ bool Bmx055GetData(bmx055Data_t* data)
     int16_t axRaw = ((int16_t) accRaw[3])<<4 | ((int16_t) accRaw[2])>>4;
     int16_t ayRaw = ((int16_t) accRaw[1])<<4 | ((int16_t) accRaw[0])>>4;
     int16_t azRaw = ((int16_t) accRaw[5])<<4 | ((int16_t) accRaw[4])>>4;
-    data->ax = (-(float)((axRaw&0x7ff)-(axRaw&0x800))*accResolution)*EARTH_GRAVITY_ACC-accXOffset;
-    data->ay = ((float)((ayRaw&0x7ff)-(ayRaw&0x800))*accResolution)*EARTH_GRAVITY_ACC-accYOffset;
-    data->az = (-(float)((azRaw&0x7ff)-(azRaw&0x800))*accResolution)*EARTH_GRAVITY_ACC-accZOffset;
+    data->ax = (-(float)((axRaw&0x7ff)-(axRaw&0x800))*accResolution)*EARTH_GRAVITY_ACC-PARAMETERS_GET(ACC_OFFSET_X);
+    data->ay = ((float)((ayRaw&0x7ff)-(ayRaw&0x800))*accResolution)*EARTH_GRAVITY_ACC-PARAMETERS_GET(ACC_OFFSET_Y);
+    data->az = (-(float)((azRaw&0x7ff)-(azRaw&0x800))*accResolution)*EARTH_GRAVITY_ACC-PARAMETERS_GET(ACC_OFFSET_Z);
 
     static uint8_t gyroRaw[6]; ///< x, y, z: lsb, msb = 3*2=6 bytes
 
@@ -390,10 +373,10 @@ bool Bmx055GetData(bmx055Data_t* data)
         return false;
     }
     /**combine bits together**/
-    data->gx = (float)((int16_t)(((int16_t) gyroRaw[4])<<8 | ((int16_t) gyroRaw[5])))*gyroResolution*M_PI/180-gyroXOffset;
-    data->gy = -(float)((int16_t)(((int16_t) gyroRaw[2])<<8 | ((int16_t) gyroRaw[3])))*gyroResolution*M_PI/180-gyroYOffset;
+    data->gx = (float)((int16_t)(((int16_t) gyroRaw[4])<<8 | ((int16_t) gyroRaw[5])))*gyroResolution*M_PI/180-PARAMETERS_GET(GYRO_OFFSET_X);
+    data->gy = -(float)((int16_t)(((int16_t) gyroRaw[2])<<8 | ((int16_t) gyroRaw[3])))*gyroResolution*M_PI/180-PARAMETERS_GET(GYRO_OFFSET_Y);
     data->gz = 0; ///< z axis broken
-    ///data->gz = (float)((int16_t)(((int16_t) gyroRaw[0])<<8 | ((int16_t) gyroRaw[1])))*gyroResolution*M_PI/180-gyroZOffset;
+    ///data->gz = (float)((int16_t)(((int16_t) gyroRaw[0])<<8 | ((int16_t) gyroRaw[1])))*gyroResolution*M_PI/180-PARAMETERS_GET(GYRO_OFFSET_Z);
 
     static uint8_t magRaw[6]; ///< x, y, z: lsb, msb = 3*2=6 bytes
 
@@ -413,9 +396,9 @@ bool Bmx055GetData(bmx055Data_t* data)
     data->my = (float)((myRaw&0xfff)-(myRaw&0x1000));
     data->mz = (float)((mzRaw&0x3fff)-(mzRaw&0x4000));
     /**compensate for offsets and sensitivity**/
-    data->mx = (data->mx*magResolution-magXOffset)*magXScale;
-    data->my = (data->my*magResolution-magYOffset)*magYScale;
-    data->mz = (data->mz*magResolution-magZOffset)*magZScale;
+    data->mx = (data->mx*magResolution-PARAMETERS_GET(MAG_OFFSET_X))*magXScale;
+    data->my = (data->my*magResolution-PARAMETERS_GET(MAG_OFFSET_Y))*magYScale;
+    data->mz = (data->mz*magResolution-PARAMETERS_GET(MAG_OFFSET_Z))*magZScale;
 
     return true;
 }
@@ -515,23 +498,23 @@ bool BMX055CalibrateAccGyro()
 
 void Bmx055SetAccOffsets(float x, float y, float z)
 {
-    accXOffset = x;
-    accYOffset = y;
-    accZOffset = z;
+    ParametersSet(PARAMETER_ACC_OFFSET_X, x);
+    ParametersSet(PARAMETER_ACC_OFFSET_Y, y);
+    ParametersSet(PARAMETER_ACC_OFFSET_Z, z);
 }
 
 void Bmx055SetGyroOffsets(float x, float y, float z)
 {
-    gyroXOffset = x;
-    gyroYOffset = y;
-    gyroZOffset = z;
+    ParametersSet(PARAMETER_GYRO_OFFSET_X, x);
+    ParametersSet(PARAMETER_GYRO_OFFSET_Y, y);
+    ParametersSet(PARAMETER_GYRO_OFFSET_Z, z);
 }
 
 void Bmx055SetMagOffsets(float x, float y, float z)
 {
-    magXOffset = x;
-    magYOffset = y;
-    magZOffset = z;
+    ParametersSet(PARAMETER_MAG_OFFSET_X, x);
+    ParametersSet(PARAMETER_MAG_OFFSET_Y, y);
+    ParametersSet(PARAMETER_MAG_OFFSET_Z, z);
 }
 
 void Bmx055SetMagSensitivity(float x, float y, float z)
@@ -728,33 +711,3 @@ static bool CheckConnection()
     return true;
 }
 
-
-static bool NvmInit()
-{
-    float data = 0;
-    if(EepromRead(EEPROM_ACC_OFFSET_X,  &data)) { accXOffset = data; }
-    if(EepromRead(EEPROM_ACC_OFFSET_Y,  &data)) { accYOffset = data; }
-    if(EepromRead(EEPROM_ACC_OFFSET_Z,  &data)) { accZOffset = data; }
-
-    if(EepromRead(EEPROM_GYRO_OFFSET_X, &data)) { gyroXOffset = data; }
-    if(EepromRead(EEPROM_GYRO_OFFSET_Y, &data)) { gyroYOffset = data; }
-    if(EepromRead(EEPROM_GYRO_OFFSET_Z, &data)) { gyroZOffset = data; }
-
-    if(EepromRead(EEPROM_MAG_OFFSET_X,  &data)) { magXOffset = data; }
-    if(EepromRead(EEPROM_MAG_OFFSET_Y,  &data)) { magYOffset = data; }
-    if(EepromRead(EEPROM_MAG_OFFSET_Z,  &data)) { magZOffset = data; }
-
-    if(!MemoryRegisterVariable(EEPROM_ACC_OFFSET_X,  &accXOffset))  {return false;}
-    if(!MemoryRegisterVariable(EEPROM_ACC_OFFSET_Y,  &accYOffset))  {return false;}
-    if(!MemoryRegisterVariable(EEPROM_ACC_OFFSET_Z,  &accZOffset))  {return false;}
-
-    if(!MemoryRegisterVariable(EEPROM_GYRO_OFFSET_X, &gyroXOffset)) {return false;}
-    if(!MemoryRegisterVariable(EEPROM_GYRO_OFFSET_Y, &gyroYOffset)) {return false;}
-    if(!MemoryRegisterVariable(EEPROM_GYRO_OFFSET_Z, &gyroZOffset)) {return false;}
-
-    if(!MemoryRegisterVariable(EEPROM_MAG_OFFSET_X,  &magXOffset))  {return false;}
-    if(!MemoryRegisterVariable(EEPROM_MAG_OFFSET_Y,  &magYOffset))  {return false;}
-    if(!MemoryRegisterVariable(EEPROM_MAG_OFFSET_Z,  &magZOffset))  {return false;}
-
-    return true;
-}
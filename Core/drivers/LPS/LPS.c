@@ -72,7 +72,7 @@ typedef union{
         uint8_t AUTO_ZERO   : 1;       ///< Autozero enable. Default value: 0.(0: normal mode; 1: Autozero enabled)
         uint8_t SW_RESET    : 1;       ///< Software reset. Default value: 0.(0: normal mode; 1: software reset).The bit is self-cleared when the reset is completed
         uint8_t I2C_EN      : 1;       ///< I2C interface enabled. Default value 0.(0: I2C enabled;1: I2C disabled)
-        uint8_t FIFO_MEAN   : 1;       ///< Register address automatically incremented during a multiple byte access with a serial interface (I2C or SPI). Default value 1.(0: disable; 1 enable)
+        uint8_t FIFO_MEAN   : 1;       ///< Enable 1Hz ODR decimation in FIFO mean mode. Default value 0.(0: disable; 1 enable)
         uint8_t STOP_ON_FTH : 1;       ///< Stop on FIFO threshold. Enable FIFO watermark level use. Default value 0(0: disable; 1: enable)
         uint8_t FIFO_EN     : 1;       ///< FIFO enable. Default value: 0.(0: disable; 1: enable)
         uint8_t BOOT        : 1;       ///< Reboot memory content. Default value: 0.(0: normal mode; 1: reboot memory content). The bit is self-cleared when the BOOT is completed.
@@ -205,6 +205,12 @@ typedef union{
 
 /** OTHER DEFINES **/
 #define PRESSURE_RESOLUTION (4096U) ///< LSB/hPa
+#define TEMPERATURE_RESOLUTION (480.0f) ///< LSB/deg C
+#define TEMPERATURE_OFFSET  (42.5f) ///< [deg C]
+
+#define SPI_READ            (0x80U) ///< bit 7: 1->read, 0->write
+#define SPI_AUTO_INCREMENT  (0x40U) ///< bit 6: register address incremented during multiple byte access
+#define SAMPLE_SIZE         (5U)    ///< PRESS_OUT_XL..TEMP_OUT_H
 
 
 /*****************************************************************************
@@ -213,8 +219,6 @@ typedef union{
 
 static SPI_HandleTypeDef *hspi;
 
-static float prevPressure = 0;
-
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
@@ -227,6 +231,15 @@ static float prevPressure = 0;
  */
 static bool ReadAddress(uint8_t address, uint8_t* data);
 
+/**@brief reads consecutive registers in single transaction
+ *
+ * @param [in] address - first register
+ * @param [out] data
+ * @param [in] size
+ * @return true if successful
+ */
+static bool ReadAddresses(uint8_t address, uint8_t* data, uint8_t size);
+
 /**@brief writes data to given address
  *
  * @param [in] address
@@ -268,7 +281,14 @@ bool LPSInit(SPI_HandleTypeDef *HSPI)
         return false;
     }
 
-    if(!WriteAddress(CTRL_REG2,0x00)){return false;}
+    /** flush fifo by going through bypass mode before stream mode **/
+    if(!WriteAddress(FIFO_CTRL,((FIFO_CTRL_t){.F_MODE = FIFO_CTRL_F_MODE__BYPASS}).raw)){return false;}
+
+    /** STOP_ON_FTH stays off, stream mode keeps full fifo depth and
+     *  overwrites oldest sample only when reader is late by more than 1.28s **/
+    if(!WriteAddress(CTRL_REG2,((CTRL_REG2_t){.FIFO_EN = 1}).raw)){return false;}
+
+    if(!WriteAddress(FIFO_CTRL,((FIFO_CTRL_t){.F_MODE = FIFO_CTRL_F_MODE_STREAM}).raw)){return false;}
 
     if(!WriteAddress(REF_P_XL,0x00)){return false;}
     if(!WriteAddress(REF_P_L,0x00)){return false;}
@@ -277,27 +297,54 @@ bool LPSInit(SPI_HandleTypeDef *HSPI)
     return true;
 }
 
-float LPSGetPressure()
+uint8_t LPSReadSamples(lpsSample_t *samples, uint8_t maxSamples)
 {
-    STATUS_REG_t status = {.raw = 0x00};
-    ReadAddress(STATUS_REG, &(status.raw));
-    if(status.P_DA == 0)
+    if(samples == NULL || maxSamples == 0)
     {
-        return prevPressure;
+        return 0;
     }
 
-    int32_t pressureRaw = 0;
-    uint8_t data[3] = {0,0,0};
+    FIFO_STATUS_t status = {.raw = 0x00};
+    if(!ReadAddress(FIFO_STATUS, &(status.raw)))
+    {
+        return 0;
+    }
+
+    uint8_t count = status.FSS;
+    if(status.EMPTY_FIFO || count == 0)
+    {
+        return 0;
+    }
 
-    ReadAddress(PRESS_OUT_XL, &data[0]);
-    ReadAddress(PRESS_OUT_L, &data[1]);
-    ReadAddress(PRESS_OUT_H, &data[2]);
+    /** newest sample was converted at most one period ago, middle of that period is assumed **/
+    uint32_t newestTimestamp = HAL_GetTick()-LPS_ODR_PERIOD_MS/2U;
 
-    pressureRaw = ((int32_t)data[0]) | ((int32_t)data[1])<<8 | ((int32_t)data[2])<<16;
+    /** drop oldest samples if caller buffer is too small **/
+    uint8_t skip = (count > maxSamples) ? (count-maxSamples) : 0;
 
-    pressureRaw = (pressureRaw&0x7FFFFF)-(pressureRaw&0x800000);
+    for(uint8_t i=0; i<count; i++)
+    {
+        uint8_t data[SAMPLE_SIZE];
+        if(!ReadAddresses(PRESS_OUT_XL, data, SAMPLE_SIZE))
+        {
+            return 0;
+        }
+        if(i < skip)
+        {
+            continue;
+        }
+
+        int32_t pressureRaw = ((int32_t)data[0]) | ((int32_t)data[1])<<8 | ((int32_t)data[2])<<16;
+        pressureRaw = (pressureRaw&0x7FFFFF)-(pressureRaw&0x800000);
+        int16_t temperatureRaw = (int16_t)(((uint16_t)data[4])<<8 | ((uint16_t)data[3]));
+
+        lpsSample_t* sample = &samples[i-skip];
+        sample->pressure = ((float)pressureRaw)/((float)PRESSURE_RESOLUTION);
+        sample->temperature = TEMPERATURE_OFFSET + ((float)temperatureRaw)/TEMPERATURE_RESOLUTION;
+        sample->timestamp = newestTimestamp - (uint32_t)(count-1U-i)*LPS_ODR_PERIOD_MS;
+    }
 
-    return ((float)pressureRaw)/((float)PRESSURE_RESOLUTION);
+    return count-skip;
 }
 
 /******************************************************************************
@@ -323,6 +370,25 @@ static bool ReadAddress(uint8_t address, uint8_t* data)
     return true;
 }
 
+static bool ReadAddresses(uint8_t address, uint8_t* data, uint8_t size)
+{
+    uint8_t message = SPI_READ | SPI_AUTO_INCREMENT | address;
+    bool status = true;
+
+    HAL_GPIO_WritePin(LPS_CS_GPIO_Port,LPS_CS_Pin,0);
+    if(HAL_OK != HAL_SPI_Transmit(hspi, &message, sizeof(message), 1000))
+    {
+        status = false;
+    }
+    else if(HAL_OK != HAL_SPI_Receive(hspi, data, size, 1000))
+    {
+        status = false;
+    }
+    HAL_GPIO_WritePin(LPS_CS_GPIO_Port,LPS_CS_Pin,1);
+
+    return status;
+}
+
 static bool WriteAddress(uint8_t address, uint8_t data)
 {
     ///TODO: check for address correctness
@@ -17,7 +17,14 @@
                        PUBLIC DEFINES / MACROS / ENUMS
 *****************************************************************************/
 
+#define LPS_ODR_PERIOD_MS   (40U)   ///< sample period for 25Hz output data rate
+#define LPS_FIFO_SIZE       (32U)   ///< on chip fifo depth, 1.28s of samples in stream mode
 
+typedef struct{
+    float pressure;         ///< [hPa]
+    float temperature;      ///< [deg C]
+    uint32_t timestamp;     ///< HAL tick [ms] at which sample was converted
+}lpsSample_t;
 
 /*****************************************************************************
                          PUBLIC INTERFACE DECLARATION
@@ -30,9 +37,13 @@
  */
 bool LPSInit(SPI_HandleTypeDef *HSPI);
 
-/**@brief gets pressure readings in [hPa] from LPS sensor
- *        max read frequency 25Hz
+/**@brief drains sensor fifo, INT_DRDY is not routed to MCU so fifo is polled,
+ *        fifo level is read first and exactly that many samples are read,
+ *        every sample with single burst transaction,
+ *        timestamps are reconstructed from output data rate back from time of call
  *
- * @return pressure reading [hPa]
+ * @param [out] samples - oldest sample first
+ * @param [in] maxSamples - size of samples array
+ * @return number of samples read, 0 if fifo empty or on error
  */
-float LPSGetPressure();
+uint8_t LPSReadSamples(lpsSample_t *samples, uint8_t maxSamples);
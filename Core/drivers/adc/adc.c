@@ -18,20 +18,78 @@
 
 #define ADC_RESOLUTION (4095.0f)  ///< 12 bit
 #define ADC_VOLTAGE_DIVIDER_MAX_VOLTAGE (28.4f)    ///< [V] calibrated with multimeter
+#define ADC_REFERENCE_VOLTAGE (3.3f)               ///< [V] nominal VDDA, VREFINT_CAL is measured at it
+
+#define ADC_CURRENT_GPIO_PORT GPIOC
+#define ADC_CURRENT_GPIO_PIN GPIO_PIN_0     ///< ADC1_IN10
+
+/** typical values from datasheet, F401 has no factory temperature calibration **/
+#define ADC_TEMPERATURE_V25 (0.76f)         ///< [V] sensor voltage at 25 deg C
+#define ADC_TEMPERATURE_SLOPE (0.0025f)     ///< [V/deg C]
+
+#define ADC_VREFINT_CAL (*((const uint16_t*)0x1FFF7A2AU))  ///< internal reference raw value at 3.3V
+
+#define ADC_TRIGGER_FREQUENCY (16000U)  ///< [Hz] scan of all channels is started by TIM5 CC1
+#define ADC_OVERSAMPLING (16U)          ///< samples summed into one decimated sample, 1kHz output
+#define ADC_FIRST_SAMPLE_TIMEOUT_MS (10U)
 
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
 *****************************************************************************/
 
+/** scan order, equals ADC rank-1 **/
+typedef enum{
+    ADC_BATTERY_VOLTAGE = 0,
+    ADC_CURRENT,
+    ADC_VREFINT,
+    ADC_TEMPERATURE,
+    ADC_CHANNELS_COUNT
+}adcChannel_t;
+
+static const uint32_t adcChannels[ADC_CHANNELS_COUNT] = {
+        [ADC_BATTERY_VOLTAGE] = ADC_CHANNEL_11,
+        [ADC_CURRENT]         = ADC_CHANNEL_10,
+        [ADC_VREFINT]         = ADC_CHANNEL_VREFINT,
+        [ADC_TEMPERATURE]     = ADC_CHANNEL_TEMPSENSOR
+};
+
+/** temperature sensor needs 10us sampling, 480 cycles at 32MHz ADC clock, whole scan takes 23us **/
+static const uint32_t adcSamplingTimes[ADC_CHANNELS_COUNT] = {
+        [ADC_BATTERY_VOLTAGE] = ADC_SAMPLETIME_84CYCLES,
+        [ADC_CURRENT]         = ADC_SAMPLETIME_84CYCLES,
+        [ADC_VREFINT]         = ADC_SAMPLETIME_144CYCLES,
+        [ADC_TEMPERATURE]     = ADC_SAMPLETIME_480CYCLES
+};
+
 static ADC_HandleTypeDef* adcHandle;
+static TIM_HandleTypeDef triggerTimer;
 
-static volatile bool waitingForMeasurement = false;
+/** two halves, each one is decimated while DMA fills the other **/
+static uint16_t dmaBuffer[2][ADC_OVERSAMPLING][ADC_CHANNELS_COUNT];
+
+/**@brief latest decimated sums, written only from interrupt
+ *        sequence is odd while sums are being written (seqlock)
+ */
+static volatile struct{
+    uint32_t sequence;
+    uint32_t sums[ADC_CHANNELS_COUNT];
+}snapshot;
 
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
 
+/**@brief configures TIM5 to generate CC1 event at ADC_TRIGGER_FREQUENCY
+ *
+ * @return true if successful
+ */
+static bool TriggerTimerInit();
 
+/**@brief sums buffer half and publishes it in snapshot
+ *
+ * @param [in] half - 0 or 1
+ */
+static void Decimate(uint8_t half);
 
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
@@ -39,32 +97,181 @@ static volatile bool waitingForMeasurement = false;
 
 bool AdcInit(ADC_HandleTypeDef* hadc)
 {
-    if(hadc == NULL)
+    if(hadc == NULL || hadc->DMA_Handle == NULL)
     {
         return false;
     }
     adcHandle = hadc;
 
-    HAL_ADC_Start(adcHandle);
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Pin = ADC_CURRENT_GPIO_PIN;
+    gpio.Mode = GPIO_MODE_ANALOG;
+    gpio.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(ADC_CURRENT_GPIO_PORT, &gpio);
+
+    adcHandle->Init.ScanConvMode = ENABLE;
+    adcHandle->Init.ContinuousConvMode = DISABLE;
+    adcHandle->Init.DiscontinuousConvMode = DISABLE;
+    adcHandle->Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
+    adcHandle->Init.ExternalTrigConv = ADC_EXTERNALTRIGCONV_T5_CC1;
+    adcHandle->Init.NbrOfConversion = ADC_CHANNELS_COUNT;
+    adcHandle->Init.DMAContinuousRequests = ENABLE;
+    adcHandle->Init.EOCSelection = ADC_EOC_SEQ_CONV;
+    if(HAL_OK != HAL_ADC_Init(adcHandle)) {return false;}
+
+    for(uint8_t channel=0; channel<ADC_CHANNELS_COUNT; channel++)
+    {
+        ADC_ChannelConfTypeDef config = {0};
+        config.Channel = adcChannels[channel];
+        config.Rank = channel+1;
+        config.SamplingTime = adcSamplingTimes[channel];
+        if(HAL_OK != HAL_ADC_ConfigChannel(adcHandle, &config)) {return false;}
+    }
+
+    /** cube configures DMA for single word transfers **/
+    adcHandle->DMA_Handle->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    adcHandle->DMA_Handle->Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    adcHandle->DMA_Handle->Init.Mode = DMA_CIRCULAR;
+    if(HAL_OK != HAL_DMA_Init(adcHandle->DMA_Handle)) {return false;}
+
+    if(HAL_OK != HAL_ADC_Start_DMA(adcHandle, (uint32_t*)dmaBuffer, sizeof(dmaBuffer)/sizeof(dmaBuffer[0][0][0])))
+    {
+        return false;
+    }
+
+    if(!TriggerTimerInit()) {return false;}
+
+    uint32_t startTime = HAL_GetTick();
+    while(snapshot.sequence == 0)
+    {
+        if(HAL_GetTick()-startTime > ADC_FIRST_SAMPLE_TIMEOUT_MS)
+        {
+            return false;
+        }
+    }
+
     return true;
 }
 
 float AdcGetBatteryVoltage()
 {
-    static uint32_t adcRaw = 0;
-    waitingForMeasurement = true;
-    HAL_ADC_Start_DMA(adcHandle,&adcRaw,1);
+    adcData_t data;
+    AdcGetData(&data);
+
+    return data.batteryVoltage;
+}
+
+bool AdcGetData(adcData_t* data)
+{
+    if(data == NULL)
+    {
+        return false;
+    }
+
+    uint32_t sums[ADC_CHANNELS_COUNT];
+    uint32_t sequence;
+
+    /** retry if sums were being written or have changed while copying **/
+    do{
+        sequence = snapshot.sequence;
+        __DMB();
+
+        for(uint8_t channel=0; channel<ADC_CHANNELS_COUNT; channel++)
+        {
+            sums[channel] = snapshot.sums[channel];
+        }
 
-    while(waitingForMeasurement){}
+        __DMB();
+    }while((sequence&1U) != 0 || sequence != snapshot.sequence);
 
-    return ((float)adcRaw)*ADC_VOLTAGE_DIVIDER_MAX_VOLTAGE/ADC_RESOLUTION;
+    float raw[ADC_CHANNELS_COUNT];
+    for(uint8_t channel=0; channel<ADC_CHANNELS_COUNT; channel++)
+    {
+        raw[channel] = ((float)sums[channel])/((float)ADC_OVERSAMPLING);
+    }
+
+    float voltsPerBit = ADC_REFERENCE_VOLTAGE/ADC_RESOLUTION;
+
+    data->batteryVoltage = raw[ADC_BATTERY_VOLTAGE]*ADC_VOLTAGE_DIVIDER_MAX_VOLTAGE/ADC_RESOLUTION;
+    data->current = (raw[ADC_CURRENT]*voltsPerBit-ADC_CURRENT_SENSOR_OFFSET)*ADC_CURRENT_SENSOR_SCALE;
+    data->vdda = raw[ADC_VREFINT] > 0 ? ADC_REFERENCE_VOLTAGE*((float)ADC_VREFINT_CAL)/raw[ADC_VREFINT] : 0;
+    data->temperature = (raw[ADC_TEMPERATURE]*voltsPerBit-ADC_TEMPERATURE_V25)/ADC_TEMPERATURE_SLOPE+25.0f;
+    data->sequence = sequence/2;
+
+    return true;
 }
 
 void AdcDmaIsr()
 {
-    waitingForMeasurement = false;
+    uint32_t flags = DMA2->LISR;
+
+    if(flags & DMA_LISR_HTIF0)
+    {
+        Decimate(0);
+    }
+
+    if(flags & DMA_LISR_TCIF0)
+    {
+        Decimate(1);
+    }
 }
 
 /******************************************************************************
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
+
+static bool TriggerTimerInit()
+{
+    /** APB1 timers run at twice the bus clock if APB1 is divided **/
+    uint32_t clock = HAL_RCC_GetPCLK1Freq();
+    if((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+    {
+        clock *= 2;
+    }
+
+    __HAL_RCC_TIM5_CLK_ENABLE();
+
+    triggerTimer.Instance = TIM5;
+    triggerTimer.Init.Prescaler = 0;
+    triggerTimer.Init.CounterMode = TIM_COUNTERMODE_UP;
+    triggerTimer.Init.Period = clock/ADC_TRIGGER_FREQUENCY-1;
+    triggerTimer.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    triggerTimer.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if(HAL_OK != HAL_TIM_PWM_Init(&triggerTimer)) {return false;}
+
+    /** PA0 alternate function stays on TIM2 buzzer, CC1 output is used only as ADC trigger **/
+    TIM_OC_InitTypeDef config = {0};
+    config.OCMode = TIM_OCMODE_PWM1;
+    config.Pulse = (clock/ADC_TRIGGER_FREQUENCY)/2;
+    config.OCPolarity = TIM_OCPOLARITY_HIGH;
+    config.OCFastMode = TIM_OCFAST_DISABLE;
+    if(HAL_OK != HAL_TIM_PWM_ConfigChannel(&triggerTimer, &config, TIM_CHANNEL_1)) {return false;}
+
+    if(HAL_OK != HAL_TIM_PWM_Start(&triggerTimer, TIM_CHANNEL_1)) {return false;}
+
+    return true;
+}
+
+static void Decimate(uint8_t half)
+{
+    uint32_t sums[ADC_CHANNELS_COUNT] = {0};
+
+    for(uint8_t sample=0; sample<ADC_OVERSAMPLING; sample++)
+    {
+        for(uint8_t channel=0; channel<ADC_CHANNELS_COUNT; channel++)
+        {
+            sums[channel] += dmaBuffer[half][sample][channel];
+        }
+    }
+
+    snapshot.sequence++;
+    __DMB();
+
+    for(uint8_t channel=0; channel<ADC_CHANNELS_COUNT; channel++)
+    {
+        snapshot.sums[channel] = sums[channel];
+    }
+
+    __DMB();
+    snapshot.sequence++;
+}
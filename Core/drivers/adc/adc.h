@@ -17,28 +17,51 @@
                        PUBLIC DEFINES / MACROS / ENUMS
 *****************************************************************************/
 
+/** current sensor output, current = (voltage-offset)*scale **/
+#ifndef ADC_CURRENT_SENSOR_SCALE
+#define ADC_CURRENT_SENSOR_SCALE (0.0f)     ///< [A/V] 0 if current sensor is not connected
+#endif
+#ifndef ADC_CURRENT_SENSOR_OFFSET
+#define ADC_CURRENT_SENSOR_OFFSET (0.0f)    ///< [V] sensor output at 0A
+#endif
 
+/**@brief latest decimated measurements **/
+typedef struct{
+    float batteryVoltage;   ///< [V]
+    float current;          ///< [A] 0 if current sensor is not configured
+    float vdda;             ///< [V] ADC reference voltage measured with internal reference
+    float temperature;      ///< [deg C] MCU die temperature
+    uint32_t sequence;      ///< incremented with every decimated sample, 0 before first one
+}adcData_t;
 
 /*****************************************************************************
                          PUBLIC INTERFACE DECLARATION
 *****************************************************************************/
 
-/**@brief initializes module
+/**@brief initializes module, starts timer triggered scan of battery voltage, current,
+ *        internal reference and temperature channels into circular DMA buffer
+ *        waits for first decimated sample
  *
  * @param [in] hadc adc instance handle
  * @return true if successful
  */
 bool AdcInit(ADC_HandleTypeDef* hadc);
 
-/**@brief reads raw adc data and calculates real battery voltage
+/**@brief reads latest decimated battery voltage, does not wait for conversion
  *
  * @return battery voltage in V
  */
 float AdcGetBatteryVoltage();
 
-/**@brief tells adc driver that measurement is ready
- *        needs to be implemented in adc dma interrupt service routine
+/**@brief reads latest decimated measurements, does not wait for conversion
+ *
+ * @param [out] data
+ * @return true if successful
  */
-void AdcDmaIsr();
+bool AdcGetData(adcData_t* data);
 
+/**@brief decimates completed half of DMA buffer
+ *        needs to be implemented in adc dma interrupt service routine before HAL handler clears flags
+ */
+void AdcDmaIsr();
 
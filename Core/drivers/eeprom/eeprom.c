@@ -2,7 +2,7 @@
  * @file /CalmarFlightController/Core/drivers/eeprom/eeprom.c
  *
  * @brief Source code
- * 
+ *
  * @author Michal Frankiewicz
  * @date Jun 15, 2021
  ****************************************************************************/
@@ -18,61 +18,129 @@
                           PRIVATE DEFINES / MACROS
 *****************************************************************************/
 
-#define EEPROM_FLASH_SECTOR FLASH_SECTOR_2
-#define EEPROM_BEGIN (0x8008000U)   ///< first eeprom address
-#define EEPROM_END (0x800BFF8U)     ///< last eeprom address
+#define SECTOR_COUNT (2U)
+#define SECTOR_SIZE (0x4000U)   ///< bytes, both sectors have the same size
 
-#define EEPROM_SIZE (EEPROM_END+8-EEPROM_BEGIN)     ///< has to be power of 2
+#define SECTOR_A_NUMBER FLASH_SECTOR_1
+#define SECTOR_A_BEGIN (0x8004000U)
+#define SECTOR_B_NUMBER FLASH_SECTOR_2
+#define SECTOR_B_BEGIN (0x8008000U)     ///< single sector eeprom used to live here without header
 
 #define EMPTY32 (0xFFFFFFFFU)   ///< value of 32bit empty index cell
 #define CELL_SIZE (8U)          ///< bytes
+#define NO_OFFSET (0xFFFFU)     ///< variable index has no cell in eeprom
+
+/** sector states, kept in first word of sector, every next state only clears bits **/
+#define SECTOR_ERASED    (0xFFFFFFFFU)
+#define SECTOR_RECEIVING (0xEEEEEEEEU)  ///< transfer in progress
+#define SECTOR_VALID     (0xAAAAAAAAU)
+#define SECTOR_OBSOLETE  (0x00000000U)  ///< newer copy exists, waits for erase
 
+#define HEADER_SIZE CELL_SIZE   ///< state word and generation word
 
+#define COMPACTION_THRESHOLD (SECTOR_SIZE*3U/4U)    ///< maintenance transfers active sector above this usage
 
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
 *****************************************************************************/
 
-/**@brief keeps track on first writable memory location
+static const uint32_t sectorBegin[SECTOR_COUNT] = {SECTOR_A_BEGIN, SECTOR_B_BEGIN};
+static const uint32_t sectorNumber[SECTOR_COUNT] = {SECTOR_A_NUMBER, SECTOR_B_NUMBER};
+
+static uint32_t activeSector = 0;
+static uint32_t generation = 0;         ///< incremented on every transfer, newer sector wins after reset
+static bool standbyErased = false;      ///< standby sector can receive transfer without erase
+
+/**@brief keeps track on first writable memory location in active sector
+ */
+static uint32_t lastVariableOffset = 0;
+
+/**@brief offset of newest cell of every variable in active sector, NO_OFFSET if variable was never written
  */
-uint32_t lastVariableOffset = 0;
+static uint16_t variableOffsets[EEPROM_VARIABLE_COUNT];
 
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
 
-/**@brief reads 32 bit data from specified addres
+/**@brief reads 32 bit word from sector
  *
- * @param [in] offset - offset from EEPROM_BEGIN
- * @param [out] data - 32 bit data pointer
+ * @param [in] sector - 0::SECTOR_COUNT-1
+ * @param [in] offset - offset from sector begin
+ * @return word
+ */
+static uint32_t ReadWord(uint32_t sector, uint32_t offset);
+
+/**@brief programs single 32 bit word, bits can only be cleared
+ *
+ * @param [in] sector
+ * @param [in] offset - offset from sector begin, multiple of 4
+ * @param [in] data
  * @return true if successful
  */
-bool ReadMemoryLocation(uint32_t offset, void* data);
+static bool WriteWord(uint32_t sector, uint32_t offset, uint32_t data);
 
 /**@brief writes data to cell under specified address
  *
- * @param [in] offset - offset from EEPROM_BEGIN, needs to be multiple of CELL_SIZE
+ * @param [in] sector
+ * @param [in] offset - offset from sector begin, needs to be multiple of CELL_SIZE
  * @param [in] index - virtual address of cell, variable index od @param data
- * @param [in] data - 32 bit data pointer
- * @return
+ * @param [in] data - 32 bit data
+ * @return true if successful
  */
-bool WriteData(uint32_t offset, uint32_t index, void* data);
+static bool WriteCell(uint32_t sector, uint32_t offset, uint32_t index, uint32_t data);
 
-/**@brief finds last non EMPTY address in EEPROM sector
- *        uses binary search
+/**@brief programs consecutive cells in one flash operation,
+ *        waits for flash only before first and after last word,
+ *        bus stalls on every next word until previous is programmed
  *
- * @return address as offset from EEPROM_BEGIN
+ * @param [in] sector
+ * @param [in] offset - offset of first cell, needs to be multiple of CELL_SIZE
+ * @param [in] indexes
+ * @param [in] values
+ * @param [in] count
+ * @return true if successful
  */
-uint32_t FindLastVariableAddress();
+static bool ProgramCells(uint32_t sector, uint32_t offset, const eepromIndexes_t* indexes, const uint32_t* values, uint32_t count);
 
-/**@brief stores all newest eeprom variables in ram array
- *        clears eeprom sector and writes variables to eeprom
+/**@brief scans written part of sector, fills offsets and finds first free cell
+ *        cells with torn data word are skipped
+ *
+ * @param [in] sector
+ * @param [in] firstCell - offset of first data cell
+ * @param [out] offsets - newest cell of every variable
+ * @return offset of first free cell
+ */
+static uint32_t ScanSector(uint32_t sector, uint32_t firstCell, uint16_t offsets[EEPROM_VARIABLE_COUNT]);
+
+/**@brief copies newest variables from active sector to standby sector
+ *        which needs to be erased or partially received, then swaps sectors
+ *
+ * @param [in] resume - standby sector is in receiving state after reset, copy only missing variables
+ * @return true if successful
  */
-void RefreshEeprom();
+static bool Transfer(bool resume);
 
-/**@brief erases FLASH sector: EEPROM_FLASH_SECTOR
+/**@brief erases FLASH sector, stalls CPU until done
+ *
+ * @param [in] sector
+ * @return true if successful
  */
-void EraseEeprom();
+static bool EraseSector(uint32_t sector);
+
+/**@brief checks if every word of sector is erased
+ *
+ * @param [in] sector
+ * @return true if sector can be programmed without erase
+ */
+static bool SectorErased(uint32_t sector);
+
+/**@brief finds active sector after reset, finishes interrupted transfer
+ *
+ * @return true if successful
+ */
+static bool RestoreSectors();
+
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
 *****************************************************************************/
@@ -83,26 +151,56 @@ bool EepromInit()
     {
         return false;
     }
-    lastVariableOffset = FindLastVariableAddress();
 
-    return true;
+    return RestoreSectors();
 }
 
 bool EepromWrite(eepromIndexes_t index, void* data)
 {
-    if(index >= EEPROM_VARIABLE_COUNT)
+    if(data == NULL)
     {
         return false;
     }
 
-    if(!WriteData(lastVariableOffset, index, data))
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+
+    return EepromWriteBatch(&index, &value, 1);
+}
+
+bool EepromWriteBatch(const eepromIndexes_t* indexes, const uint32_t* values, uint32_t count)
+{
+    if(indexes == NULL || values == NULL || count > EEPROM_VARIABLE_COUNT)
+    {
+        return false;
+    }
+
+    for(uint32_t i=0; i<count; i++)
+    {
+        if(indexes[i] >= EEPROM_VARIABLE_COUNT)
+        {
+            return false;
+        }
+    }
+
+    if(lastVariableOffset+count*CELL_SIZE > SECTOR_SIZE)
+    {
+        /** maintenance did not run in time, transfer is possible only without erase **/
+        if(!standbyErased || !Transfer(false))
+        {
+            return false;
+        }
+    }
+
+    if(!ProgramCells(activeSector, lastVariableOffset, indexes, values, count))
     {
         return false;
     }
 
-    if((lastVariableOffset+=CELL_SIZE) >= EEPROM_SIZE)
+    for(uint32_t i=0; i<count; i++)
     {
-        RefreshEeprom();
+        variableOffsets[indexes[i]] = (uint16_t)lastVariableOffset;
+        lastVariableOffset += CELL_SIZE;
     }
 
     return true;
@@ -110,46 +208,109 @@ bool EepromWrite(eepromIndexes_t index, void* data)
 
 bool EepromRead(eepromIndexes_t index, void* data)
 {
-    for(int32_t offset = lastVariableOffset; offset>=0; offset -= CELL_SIZE)
+    if(index >= EEPROM_VARIABLE_COUNT || variableOffsets[index] == NO_OFFSET)
     {
-        uint32_t ind;
-        ReadMemoryLocation(offset,&ind);
+        return false;
+    }
+
+    uint32_t value = ReadWord(activeSector, variableOffsets[index]+CELL_SIZE/2);
+    memcpy(data, &value, sizeof(value));
+
+    return true;
+}
 
-        if(ind == index)
+bool EepromMaintenance(bool eraseAllowed)
+{
+    if(!standbyErased && eraseAllowed)
+    {
+        if(!EraseSector(1U-activeSector))
         {
-            return ReadMemoryLocation(offset+CELL_SIZE/2,data);
+            return false;
         }
+        standbyErased = true;
+    }
+
+    if(standbyErased && lastVariableOffset >= COMPACTION_THRESHOLD)
+    {
+        return Transfer(false);
     }
 
-    return false;
+    return true;
 }
 
 /******************************************************************************
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
 
-bool ReadMemoryLocation(uint32_t offset, void* data)
+static uint32_t ReadWord(uint32_t sector, uint32_t offset)
 {
-    if(offset > EEPROM_SIZE-CELL_SIZE/2)
+    return *(volatile uint32_t*)(sectorBegin[sector]+offset);
+}
+
+static bool WriteWord(uint32_t sector, uint32_t offset, uint32_t data)
+{
+    if(offset > SECTOR_SIZE-sizeof(uint32_t))
     {
         return false;
     }
 
-    memcpy(data, (void*)(EEPROM_BEGIN+offset), sizeof(uint32_t));
-    
-    return true;
+    while((FLASH->SR&FLASH_SR_BSY) != 0){}
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | \
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+
+    FLASH->CR = 0x00000000;
+    FLASH->CR |= FLASH_PSIZE_WORD;
+    FLASH->CR |= FLASH_CR_PG;
+
+    *(volatile uint32_t*)(sectorBegin[sector]+offset) = data;
+
+    while((FLASH->SR&FLASH_SR_BSY) != 0){}
+    FLASH->CR &= ~FLASH_CR_PG;
+
+    if(__HAL_FLASH_GET_FLAG((FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | \
+                               FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR | FLASH_FLAG_RDERR)) != RESET)
+    {
+        return false;
+    }
+
+    return ReadWord(sector, offset) == data;
 }
 
-bool WriteData(uint32_t offset, uint32_t index, void* data)
+static bool WriteCell(uint32_t sector, uint32_t offset, uint32_t index, uint32_t data)
 {
+    /** index first, cell with index and empty data is recognized as torn write **/
+    if(!WriteWord(sector, offset, index))
+    {
+        return false;
+    }
+    return WriteWord(sector, offset+CELL_SIZE/2, data);
+}
+
+static bool ProgramCells(uint32_t sector, uint32_t offset, const eepromIndexes_t* indexes, const uint32_t* values, uint32_t count)
+{
+    if(offset+count*CELL_SIZE > SECTOR_SIZE)
+    {
+        return false;
+    }
+
     while((FLASH->SR&FLASH_SR_BSY) != 0){}
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | \
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
 
     FLASH->CR = 0x00000000;
     FLASH->CR |= FLASH_PSIZE_WORD;
     FLASH->CR |= FLASH_CR_PG;
 
-    *(uint32_t*)(EEPROM_BEGIN+offset) = (uint32_t)index;
-    *(uint32_t*)(EEPROM_BEGIN+offset+4) = *(uint32_t*)data;
+    volatile uint32_t* cell = (volatile uint32_t*)(sectorBegin[sector]+offset);
+    for(uint32_t i=0; i<count; i++)
+    {
+        /** index first, cell with index and empty data is recognized as torn write **/
+        *cell++ = (uint32_t)indexes[i];
+        *cell++ = values[i];
+    }
+
+    while((FLASH->SR&FLASH_SR_BSY) != 0){}
+    FLASH->CR &= ~FLASH_CR_PG;
 
     if(__HAL_FLASH_GET_FLAG((FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | \
                                FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR | FLASH_FLAG_RDERR)) != RESET)
@@ -157,95 +318,198 @@ bool WriteData(uint32_t offset, uint32_t index, void* data)
         return false;
     }
 
+    for(uint32_t i=0; i<count; i++)
+    {
+        if(ReadWord(sector, offset+i*CELL_SIZE) != (uint32_t)indexes[i] ||
+           ReadWord(sector, offset+i*CELL_SIZE+CELL_SIZE/2) != values[i])
+        {
+            return false;
+        }
+    }
+
     return true;
 }
 
-uint32_t FindLastVariableAddress()
+static uint32_t ScanSector(uint32_t sector, uint32_t firstCell, uint16_t offsets[EEPROM_VARIABLE_COUNT])
 {
-    uint32_t offset = EEPROM_SIZE/2;
-    uint32_t step = EEPROM_SIZE/2;
-    
-    while(step >= CELL_SIZE)
-    {
-        step = step/2;
-        uint32_t data;
-        ReadMemoryLocation(offset, &data);
-        
-        if(data == EMPTY32)
+    memset(offsets, 0xFF, EEPROM_VARIABLE_COUNT*sizeof(uint16_t));
+
+    /** forward scan, later cells overwrite older ones **/
+    uint32_t offset = firstCell;
+    for(; offset<SECTOR_SIZE; offset += CELL_SIZE)
+    {
+        uint32_t index = ReadWord(sector, offset);
+        if(index == EMPTY32)
         {
-            ReadMemoryLocation(offset-CELL_SIZE, &data);
-            if(data != EMPTY32)
-            { 
-                return offset;
-            }
-
-            offset -= step;
-        } else {
-            if(offset == EEPROM_SIZE-CELL_SIZE)
-            {
-                RefreshEeprom();
-                return 0;
-            }
-            
-            ReadMemoryLocation(offset+CELL_SIZE, &data);
-            if(data == EMPTY32)
-            {
-                return offset+CELL_SIZE;
-            }
-
-            offset += step;
+            break;
+        }
+
+        if(index < EEPROM_VARIABLE_COUNT && ReadWord(sector, offset+CELL_SIZE/2) != EMPTY32)
+        {
+            offsets[index] = (uint16_t)offset;
         }
     }
 
-    return 0;
+    return offset;
 }
 
-void RefreshEeprom()
+static bool Transfer(bool resume)
 {
-    uint32_t  variables[EEPROM_VARIABLE_COUNT];
-    bool variablesDone[EEPROM_VARIABLE_COUNT];
-    uint32_t variablesDoneSum = 0;
+    /** static to keep maintenance task stack small, eeprom access is serialized by caller **/
+    static uint16_t standbyOffsets[EEPROM_VARIABLE_COUNT];
+    static eepromIndexes_t indexes[EEPROM_VARIABLE_COUNT];
+    static uint32_t values[EEPROM_VARIABLE_COUNT];
 
-    memset(variables,0,EEPROM_VARIABLE_COUNT*sizeof(uint32_t));
-    memset(variablesDone,0,EEPROM_VARIABLE_COUNT*sizeof(bool));
+    uint32_t standby = 1U-activeSector;
+    uint32_t offset = HEADER_SIZE;
 
-    for(int32_t offset = EEPROM_SIZE-CELL_SIZE;
-            offset>=0 && variablesDoneSum<EEPROM_VARIABLE_COUNT;
-                offset -= CELL_SIZE)
+    if(resume)
+    {
+        offset = ScanSector(standby, HEADER_SIZE, standbyOffsets);
+    } else
     {
-        uint32_t index;
-        ReadMemoryLocation(offset, &index);
-        if((index < EEPROM_VARIABLE_COUNT) && (variablesDone[index] == false))
+        memset(standbyOffsets, 0xFF, sizeof(standbyOffsets));
+        if(!WriteCell(standby, 0, SECTOR_RECEIVING, generation+1U))
         {
-            ReadMemoryLocation(offset+CELL_SIZE/2, (&variables[index]));
-
-            variablesDone[index] = true;
-            variablesDoneSum++;
+            return false;
         }
     }
+    standbyErased = false;
 
-    EraseEeprom();
-
-    lastVariableOffset = 0;
+    uint32_t count = 0;
 
     for(uint32_t index=0; index<EEPROM_VARIABLE_COUNT; index++)
     {
-        if(variablesDone[index])
+        if(variableOffsets[index] == NO_OFFSET || standbyOffsets[index] != NO_OFFSET)
         {
-            EepromWrite(index, (&variables[index]));
+            continue;
         }
+
+        indexes[count] = (eepromIndexes_t)index;
+        values[count] = ReadWord(activeSector, variableOffsets[index]+CELL_SIZE/2);
+        count++;
+    }
+
+    if(!ProgramCells(standby, offset, indexes, values, count))
+    {
+        return false;
     }
+
+    for(uint32_t i=0; i<count; i++)
+    {
+        standbyOffsets[indexes[i]] = (uint16_t)offset;
+        offset += CELL_SIZE;
+    }
+
+    /** new copy is complete before old one is given up, reset at any point keeps one valid sector **/
+    if(!WriteWord(standby, 0, SECTOR_VALID)){return false;}
+    if(!WriteWord(activeSector, 0, SECTOR_OBSOLETE)){return false;}
+
+    generation = ReadWord(standby, CELL_SIZE/2);
+    activeSector = standby;
+    lastVariableOffset = offset;
+    memcpy(variableOffsets, standbyOffsets, sizeof(variableOffsets));
+
+    return true;
 }
 
-void EraseEeprom()
+static bool EraseSector(uint32_t sector)
 {
     while((FLASH->SR&FLASH_SR_BSY) != 0){}
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | \
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
 
     FLASH->CR = 0x00000000;
-    FLASH->CR |= FLASH_PSIZE_DOUBLE_WORD;
-    FLASH->CR |= EEPROM_FLASH_SECTOR<<FLASH_CR_SNB_Pos;
+    FLASH->CR |= FLASH_PSIZE_WORD;
+    FLASH->CR |= sectorNumber[sector]<<FLASH_CR_SNB_Pos;
     FLASH->CR |= FLASH_CR_SER;
     FLASH->CR |= FLASH_CR_STRT;
 
     while((FLASH->SR&FLASH_SR_BSY) != 0){}
+    FLASH->CR &= ~FLASH_CR_SER;
+
+    return SectorErased(sector);
+}
+
+static bool SectorErased(uint32_t sector)
+{
+    for(uint32_t offset=0; offset<SECTOR_SIZE; offset+=sizeof(uint32_t))
+    {
+        if(ReadWord(sector, offset) != EMPTY32)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool RestoreSectors()
+{
+    uint32_t state[SECTOR_COUNT];
+    for(uint32_t sector=0; sector<SECTOR_COUNT; sector++)
+    {
+        state[sector] = ReadWord(sector, 0);
+    }
+
+    /** both valid if reset came between marking new sector valid and old obsolete **/
+    if(state[0] == SECTOR_VALID && state[1] == SECTOR_VALID)
+    {
+        int32_t age = (int32_t)(ReadWord(1, CELL_SIZE/2)-ReadWord(0, CELL_SIZE/2));
+        uint32_t older = age > 0 ? 0 : 1;
+        if(!WriteWord(older, 0, SECTOR_OBSOLETE)){return false;}
+        state[older] = SECTOR_OBSOLETE;
+    }
+
+    bool legacy = false;
+    if(state[0] == SECTOR_VALID)
+    {
+        activeSector = 0;
+    } else if(state[1] == SECTOR_VALID)
+    {
+        activeSector = 1;
+    } else if(state[1] > 0 && state[1] < EEPROM_VARIABLE_COUNT)
+    {
+        /** single sector eeprom from older firmware, cells start without header **/
+        activeSector = 1;
+        legacy = true;
+    } else if(state[0] == SECTOR_RECEIVING || state[1] == SECTOR_RECEIVING)
+    {
+        /** old sector is lost, partially received copy is the best we have **/
+        activeSector = state[0] == SECTOR_RECEIVING ? 0 : 1;
+        if(!WriteWord(activeSector, 0, SECTOR_VALID)){return false;}
+    } else
+    {
+        /** no data, format first sector, erase at boot is safe **/
+        activeSector = 0;
+        if(!SectorErased(0))
+        {
+            if(!EraseSector(0)){return false;}
+        }
+        if(!WriteCell(0, 0, SECTOR_VALID, 0)){return false;}
+    }
+
+    generation = legacy ? 0 : ReadWord(activeSector, CELL_SIZE/2);
+    lastVariableOffset = ScanSector(activeSector, legacy ? 0 : HEADER_SIZE, variableOffsets);
+
+    uint32_t standby = 1U-activeSector;
+    standbyErased = SectorErased(standby);
+
+    if(state[standby] == SECTOR_RECEIVING)
+    {
+        return Transfer(true);
+    }
+
+    if(legacy)
+    {
+        /** move to headered layout right away, standby held code of older firmware **/
+        if(!standbyErased)
+        {
+            if(!EraseSector(standby)){return false;}
+            standbyErased = true;
+        }
+        return Transfer(false);
+    }
+
+    return true;
 }
@@ -15,30 +15,18 @@
                        PUBLIC DEFINES / MACROS / ENUMS
 *****************************************************************************/
 
+/**@brief persistent keys, values 1::EEPROM_PARAMETERS_KEY_LAST are assigned to parameters
+ *        in middleware/parameters/parameterTable.h
+ */
 typedef enum{
-    EEPROM_ACC_OFFSET_X = 1,
-    EEPROM_ACC_OFFSET_Y,
-    EEPROM_ACC_OFFSET_Z,
-
-    EEPROM_GYRO_OFFSET_X,
-    EEPROM_GYRO_OFFSET_Y,
-    EEPROM_GYRO_OFFSET_Z,
-
-    EEPROM_MAG_OFFSET_X,
-    EEPROM_MAG_OFFSET_Y,
-    EEPROM_MAG_OFFSET_Z,
+    EEPROM_NO_KEY = 0,              ///< variable is not persistent
 
-    EEPROM_PID_XY_P,
-    EEPROM_PID_XY_I,
-    EEPROM_PID_XY_D,
+    EEPROM_PARAMETERS_KEY_LAST = 63,///< keys of removed parameters must not be reused
 
-    EEPROM_PID_Z_P,
-    EEPROM_PID_Z_I,
-    EEPROM_PID_Z_D,
+    EEPROM_PARAMETERS_SCHEMA,       ///< hash of parameter table stored values were written with
+    EEPROM_PARAMETERS_SIGNATURES,   ///< signature (name, type) of parameter with key k is stored at this index + k
 
-    EEPROM_PID_N,
-
-    EEPROM_VARIABLE_COUNT   ///< max amount of alowed eeprom indexes, not  valid variable
+    EEPROM_VARIABLE_COUNT = EEPROM_PARAMETERS_SIGNATURES+EEPROM_PARAMETERS_KEY_LAST+1   ///< max amount of alowed eeprom indexes, not  valid variable
 }eepromIndexes_t;
 
 
@@ -46,13 +34,15 @@ typedef enum{
                          PUBLIC INTERFACE DECLARATION
 *****************************************************************************/
 
-/**@brief initializes eeprom
+/**@brief initializes eeprom, finds active sector of ping-pong pair and finishes
+ *        transfer interrupted by reset
  *
  * @return true if successful
  */
 bool EepromInit();
 
 /**@brief writes data under given eeprom index
+ *        never erases flash, fails if active sector is full and standby sector is not erased
  *
  * @param [in] index - 0::EEPROM_VARIABLE_COUNT-1
  * @param [in] data - 32 bit data pointer
@@ -60,6 +50,24 @@ bool EepromInit();
  */
 bool EepromWrite(eepromIndexes_t index, void* data);
 
+/**@brief writes several variables in one flash programming sequence
+ *        never erases flash, fails if active sector cannot fit whole batch
+ *
+ * @param [in] indexes - 0::EEPROM_VARIABLE_COUNT-1
+ * @param [in] values - 32 bit raw values
+ * @param [in] count - up to EEPROM_VARIABLE_COUNT
+ * @return true if successful
+ */
+bool EepromWriteBatch(const eepromIndexes_t* indexes, const uint32_t* values, uint32_t count);
+
+/**@brief erases obsolete standby sector and transfers active sector when it is filling up,
+ *        call regularly from low priority task, erase stalls CPU for hundreds of ms
+ *
+ * @param [in] eraseAllowed - false while armed, only transfer without erase is done
+ * @return true if successful
+ */
+bool EepromMaintenance(bool eraseAllowed);
+
 /**@brief reads data from under given index
  *
  * @param [in] index - 0::EEPROM_VARIABLE_COUNT-1
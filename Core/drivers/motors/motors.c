@@ -9,65 +9,664 @@
 
 #include "drivers/motors/motors.h"
 
+#include <string.h>
+
 /*****************************************************************************
                           PRIVATE DEFINES / MACROS
 *****************************************************************************/
 
-#define CCR_MIN_VALUE (1000U)   ///< equals 1ms
-#define CCR_RANGE (1000.0f)     ///< equals 1ms
+#define CCR_MIN_VALUE (1000U)   ///< equals 1ms for PWM timer configuration from cube
+#define CCR_RANGE (1000.0f)     ///< equals 1ms for PWM timer configuration from cube
+
+/** motor timer update DMA request, DMA2 stream 5 channel 6 **/
+#define MOTORS_DMA_STREAM DMA2_Stream5
+#define MOTORS_DMA_CHANNEL DMA_CHANNEL_6
+
+#define DSHOT_FRAME_BITS (16U)
+#define DSHOT_FRAME_ROWS (150U)     ///< bits + low gap, one row is one timer period for all motors
+#define DSHOT_SAFE_ROWS (4U)        ///< rows before frame start at which new frame cannot be written anymore
+#define DSHOT_THROTTLE_MIN (48U)    ///< 0 is motor stop, 1-47 are commands
+#define DSHOT_THROTTLE_MAX (2047U)
+
+/** motor n is on pin PA8+n, TIM1 CH1..CH4 **/
+#define MOTORS_GPIO GPIOA
+#define MOTORS_GPIO_PIN_SHIFT (8U)
+#define MOTORS_GPIO_PINS (0x0FU<<MOTORS_GPIO_PIN_SHIFT)
+#define MOTORS_GPIO_MODER_MASK (0xFFU<<(2*MOTORS_GPIO_PIN_SHIFT))
+#define MOTORS_GPIO_MODER_AF (0xAAU<<(2*MOTORS_GPIO_PIN_SHIFT))
+#define MOTORS_GPIO_PUPDR_UP (0x55U<<(2*MOTORS_GPIO_PIN_SHIFT))
+
+/** interrupt does not use FreeRTOS API, it is above syscall priority so kernel critical sections
+ *  cannot delay switching pins past ESC answer **/
+#define MOTORS_DMA_IRQ DMA2_Stream5_IRQn
+#define MOTORS_DMA_IRQ_PRIORITY (4U)
+#define MOTORS_DMA_FLAGS (DMA_HIFCR_CTCIF5|DMA_HIFCR_CHTIF5|DMA_HIFCR_CTEIF5|DMA_HIFCR_CDMEIF5|DMA_HIFCR_CFEIF5)
+
+#define DSHOT_TELEMETRY_BITS (21U)          ///< start bit + 20 bit GCR
+#define DSHOT_TELEMETRY_MIN_BITS (18U)      ///< last run at idle level is filled up to 21 bits
+#define DSHOT_TELEMETRY_OVERSAMPLING (3U)   ///< samples per answer bit
+#define DSHOT_TELEMETRY_TURNAROUND (0.000045f)  ///< [s] max answer delay after frame end, 30us nominal
+#define DSHOT_TELEMETRY_MARGIN_BITS (4U)
+#define DSHOT_TELEMETRY_SAMPLES (192U)      ///< enough for DShot600 window
+#define DSHOT_TELEMETRY_STOPPED (0x0FFFU)   ///< eRPM period value sent by stopped motor
+#define DSHOT_TELEMETRY_INVALID_GCR (0xFFU)
 
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
 *****************************************************************************/
 
 static TIM_HandleTypeDef* htim;
+static DMA_HandleTypeDef motorsDma;
+
+static motorsProtocol_t motorsProtocol = MOTORS_PROTOCOL_PWM;
+
+static float motorsPower[MOTORS_COUNT] = {0};
+
+/**@brief analog ESC protocol pulse timing **/
+typedef struct{
+    float minPulse;     ///< [s] pulse for power 0
+    float pulseRange;   ///< [s] pulse increase for power 1
+    float period;       ///< [s] pulse repeat period when no commit arrives
+}analogProtocol_t;
+
+static const analogProtocol_t analogProtocols[MOTORS_PROTOCOL_COUNT] = {
+        [MOTORS_PROTOCOL_ONESHOT125] = {0.000125f, 0.000125f, 0.0005f},
+        [MOTORS_PROTOCOL_MULTISHOT]  = {0.000005f, 0.00002f,  0.00004f}
+};
+
+/** analog protocols CCR values **/
+static uint16_t ccrMin = CCR_MIN_VALUE;
+static float ccrRange = CCR_RANGE;
+static bool retrigger = false;
+
+/** DShot bit durations in timer ticks **/
+static uint16_t dshotBit0 = 0;
+static uint16_t dshotBit1 = 0;
+
+/** CCR1..CCR4 values for every timer period, sent by circular DMA burst,
+ *  bidirectional DShot sends low gap first and frame bits at the end, followed by one idle row **/
+static uint16_t dshotBuffer[DSHOT_FRAME_ROWS][MOTORS_COUNT];
+static uint16_t dshotDataRow = 0;   ///< first row of frame bits
+static uint32_t dshotBitTicks = 0;
+
+/** bidirectional DShot telemetry **/
+static bool dshotBidir = false;
+static uint32_t telemetryDcr = 0;           ///< timer DMA burst configuration restored after sampling
+static uint32_t telemetrySampleTicks = 0;
+static uint16_t telemetrySampleCount = 0;
+static uint16_t telemetrySamples[2][DSHOT_TELEMETRY_SAMPLES];   ///< GPIO IDR samples, written by DMA
+static uint8_t telemetryWriteBuffer = 0;
+static volatile uint8_t telemetryReadyBuffer = 0;
+static volatile uint32_t telemetrySequence = 0;
+static volatile bool telemetryReceiving = false;
+static uint32_t telemetryLastSequence = 0;
+
+/** 5 bit GCR code to nibble **/
+static const uint8_t gcrDecode[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0x09, 0x0A, 0x0B, 0xFF, 0x0D, 0x0E, 0x0F,
+        0xFF, 0xFF, 0x02, 0x03, 0xFF, 0x05, 0x06, 0x07,
+        0xFF, 0x00, 0x08, 0x01, 0xFF, 0x04, 0x0C, 0xFF
+};
+
+/** [bit/s] **/
+static const uint32_t dshotBitrate[MOTORS_PROTOCOL_COUNT] = {
+        [MOTORS_PROTOCOL_DSHOT150] = 150000,
+        [MOTORS_PROTOCOL_DSHOT300] = 300000,
+        [MOTORS_PROTOCOL_DSHOT600] = 600000,
+        [MOTORS_PROTOCOL_DSHOT300_BIDIR] = 300000,
+        [MOTORS_PROTOCOL_DSHOT600_BIDIR] = 600000
+};
 
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
 
+/**@brief reconfigures timer and starts circular DMA burst,
+ *        for bidirectional DShot inverts outputs and starts normal mode burst with interrupt
+ *
+ * @return true if successful
+ */
+static bool DshotInit();
+
+/**@brief reconfigures timer for OneShot125 / Multishot
+ */
+static void AnalogInit();
 
+/**@brief checks if protocol is DShot
+ *
+ * @param [in] protocol
+ * @return true if DShot
+ */
+static bool IsDshot(motorsProtocol_t protocol);
+
+/**@brief calculates motor timer input clock
+ *
+ * @return timer clock [Hz]
+ */
+static uint32_t GetTimerClock();
+
+/**@brief checks if protocol is bidirectional DShot
+ *
+ * @param [in] protocol
+ * @return true if bidirectional DShot
+ */
+static bool IsDshotBidir(motorsProtocol_t protocol);
+
+/**@brief calculates DShot packet with checksum, telemetry bit is not set,
+ *        checksum is inverted for bidirectional DShot
+ *
+ * @param [in] power - range 0:1
+ * @return DShot packet
+ */
+static uint16_t DshotPacket(float power);
+
+/**@brief decodes edge encoded GCR answers of all motors from one sampling window
+ *
+ * @param [in] samples - telemetrySampleCount GPIO IDR samples
+ * @param [out] values - 12 bit eRPM period values without checksum
+ * @return mask of motors with valid answer
+ */
+static uint8_t DecodeTelemetry(const uint16_t* samples, uint16_t values[MOTORS_COUNT]);
+
+/**@brief converts eRPM period value to rotor speed
+ *
+ * @param [in] value - 3 bit exponent, 9 bit period in us
+ * @return [rev/min]
+ */
+static float TelemetryToRpm(uint16_t value);
+
+/**@brief writes motorsPower to timer
+ */
+static void Commit();
 
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
 *****************************************************************************/
 
-bool MotorsInit(TIM_HandleTypeDef* hTim)
+bool MotorsInit(TIM_HandleTypeDef* hTim, motorsProtocol_t protocol)
 {
-    if(hTim == NULL)
+    if(hTim == NULL || protocol >= MOTORS_PROTOCOL_COUNT)
     {
         return false;
     }
 
     htim = hTim;
+    motorsProtocol = protocol;
+
+    if(IsDshot(motorsProtocol))
+    {
+        if(!DshotInit()) {return false;}
+    } else if(motorsProtocol != MOTORS_PROTOCOL_PWM)
+    {
+        AnalogInit();
+    }
+
     HAL_TIM_Base_Start(htim);
     if(HAL_OK != HAL_TIM_PWM_Start(htim,TIM_CHANNEL_1)) {return false;}
     if(HAL_OK != HAL_TIM_PWM_Start(htim,TIM_CHANNEL_2)) {return false;}
     if(HAL_OK != HAL_TIM_PWM_Start(htim,TIM_CHANNEL_3)) {return false;}
     if(HAL_OK != HAL_TIM_PWM_Start(htim,TIM_CHANNEL_4)) {return false;}
 
+    Commit();
+
     return true;
 }
 
 void MotorsSet(motors_t motor, float power)
 {
-    if(motor > MOTORS_FRONT_RIGHT)
+    if(motor >= MOTORS_COUNT)
     {
         return;
     }
 
-    if(power > 1)
+    motorsPower[motor] = power;
+    Commit();
+}
+
+void MotorsSetAll(const float power[MOTORS_COUNT])
+{
+    if(power == NULL)
     {
-        power = 1;
-    } else if(power < 0)
+        return;
+    }
+
+    memcpy(motorsPower, power, sizeof(motorsPower));
+    Commit();
+}
+
+bool MotorsGetTelemetry(motorsTelemetry_t* telemetry)
+{
+    if(telemetry == NULL || !dshotBidir)
     {
-        power = 0;
+        return false;
     }
-    uint16_t ccrValue = ((uint16_t)(CCR_RANGE*power))+CCR_MIN_VALUE;
-    *(&(htim->Instance->CCR1) + motor) = ccrValue;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t sequence = telemetrySequence;
+    uint8_t buffer = telemetryReadyBuffer;
+    __set_PRIMASK(primask);
+
+    if(sequence == telemetryLastSequence)
+    {
+        return false;
+    }
+
+    uint16_t values[MOTORS_COUNT];
+    uint8_t validMask = DecodeTelemetry(telemetrySamples[buffer], values);
+
+    /** decoded buffer is written again by the window after next one **/
+    primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t windows = telemetrySequence-sequence;
+    bool receiving = telemetryReceiving;
+    __set_PRIMASK(primask);
+
+    if(windows > 1 || (windows == 1 && receiving))
+    {
+        return false;
+    }
+
+    telemetryLastSequence = sequence;
+
+    for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+    {
+        telemetry->rpm[motor] = (validMask & (1U<<motor)) ? TelemetryToRpm(values[motor]) : 0;
+    }
+    telemetry->validMask = validMask;
+    telemetry->sequence = sequence;
+
+    return true;
+}
+
+void MotorsGetPower(float power[MOTORS_COUNT])
+{
+    if(power == NULL)
+    {
+        return;
+    }
+
+    memcpy(power, motorsPower, sizeof(motorsPower));
+}
+
+void MotorsDmaIsr()
+{
+    TIM_TypeDef* tim = htim->Instance;
+    DMA_Stream_TypeDef* stream = MOTORS_DMA_STREAM;
+
+    bool transferComplete = (DMA2->HISR & DMA_HISR_TCIF5) != 0;
+    DMA2->HIFCR = MOTORS_DMA_FLAGS;
+    if(!transferComplete)
+    {
+        return;
+    }
+
+    if(!telemetryReceiving)
+    {
+        /** last frame bit is still on the pins, idle row is loaded at next update **/
+        tim->SR = ~TIM_SR_UIF;
+        while(!(tim->SR & TIM_SR_UIF)){}
+
+        MOTORS_GPIO->MODER &= ~MOTORS_GPIO_MODER_MASK;
+
+        /** single DMA request per update, stream reads GPIO instead of DMAR **/
+        tim->DCR = 0;
+        tim->ARR = telemetrySampleTicks-1;
+        stream->CR &= ~DMA_SxCR_DIR;
+        stream->PAR = (uint32_t)&(MOTORS_GPIO->IDR);
+        stream->M0AR = (uint32_t)telemetrySamples[telemetryWriteBuffer];
+        stream->NDTR = telemetrySampleCount;
+        telemetryReceiving = true;
+    } else
+    {
+        MOTORS_GPIO->MODER |= MOTORS_GPIO_MODER_AF;
+
+        telemetryReadyBuffer = telemetryWriteBuffer;
+        telemetryWriteBuffer ^= 1;
+        telemetrySequence++;
+
+        tim->DCR = telemetryDcr;
+        tim->ARR = dshotBitTicks-1;
+        stream->CR |= DMA_SxCR_DIR_0;
+        stream->PAR = (uint32_t)&(tim->DMAR);
+        stream->M0AR = (uint32_t)dshotBuffer;
+        stream->NDTR = DSHOT_FRAME_ROWS*MOTORS_COUNT;
+        telemetryReceiving = false;
+    }
+
+    stream->CR |= DMA_SxCR_EN;
+    tim->EGR = TIM_EGR_UG;
 }
 
 /******************************************************************************
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
 
+static bool DshotInit()
+{
+    uint32_t clock = GetTimerClock();
+    dshotBitTicks = clock/dshotBitrate[motorsProtocol];
+    dshotBidir = IsDshotBidir(motorsProtocol);
+
+    dshotBit0 = (uint16_t)(dshotBitTicks*3/8);
+    dshotBit1 = (uint16_t)(dshotBitTicks*3/4);
+
+    memset(dshotBuffer, 0, sizeof(dshotBuffer));
+
+    __HAL_TIM_SET_PRESCALER(htim, 0);
+    __HAL_TIM_SET_AUTORELOAD(htim, dshotBitTicks-1);
+    htim->Instance->EGR = TIM_EGR_UG;
+
+    if(dshotBidir)
+    {
+        /** answer bitrate is 5/4 of frame bitrate **/
+        uint32_t sampleRate = dshotBitrate[motorsProtocol]*5/4*DSHOT_TELEMETRY_OVERSAMPLING;
+        telemetrySampleTicks = (clock+sampleRate/2)/sampleRate;
+        telemetrySampleCount = (uint16_t)(DSHOT_TELEMETRY_TURNAROUND*(float)sampleRate)+
+                               (DSHOT_TELEMETRY_BITS+DSHOT_TELEMETRY_MARGIN_BITS)*DSHOT_TELEMETRY_OVERSAMPLING;
+        if(telemetrySampleCount > DSHOT_TELEMETRY_SAMPLES)
+        {
+            telemetrySampleCount = DSHOT_TELEMETRY_SAMPLES;
+        }
+
+        /** frame at the end of transfer so pins can be switched to inputs right after it **/
+        dshotDataRow = DSHOT_FRAME_ROWS-DSHOT_FRAME_BITS-1;
+
+        /** idle high, line is pulled up while ESC is not driving it **/
+        htim->Instance->CCER |= TIM_CCER_CC1P|TIM_CCER_CC2P|TIM_CCER_CC3P|TIM_CCER_CC4P;
+        MOTORS_GPIO->PUPDR = (MOTORS_GPIO->PUPDR & ~MOTORS_GPIO_MODER_MASK)|MOTORS_GPIO_PUPDR_UP;
+    }
+
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    motorsDma.Instance = MOTORS_DMA_STREAM;
+    motorsDma.Init.Channel = MOTORS_DMA_CHANNEL;
+    motorsDma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    motorsDma.Init.PeriphInc = DMA_PINC_DISABLE;
+    motorsDma.Init.MemInc = DMA_MINC_ENABLE;
+    motorsDma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    motorsDma.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    motorsDma.Init.Mode = dshotBidir ? DMA_NORMAL : DMA_CIRCULAR;
+    motorsDma.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+    motorsDma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if(HAL_OK != HAL_DMA_Init(&motorsDma)) {return false;}
+
+    __HAL_LINKDMA(htim, hdma[TIM_DMA_ID_UPDATE], motorsDma);
+
+    /** DMA interrupt is not enabled, circular transfer runs without CPU,
+     *  bidirectional DShot uses transfer complete interrupt to switch between frame and answer **/
+    if(HAL_OK != HAL_TIM_DMABurst_MultiWriteStart(htim,
+                                                  TIM_DMABASE_CCR1,
+                                                  TIM_DMA_UPDATE,
+                                                  (uint32_t*)dshotBuffer,
+                                                  TIM_DMABURSTLENGTH_4TRANSFERS,
+                                                  DSHOT_FRAME_ROWS*MOTORS_COUNT))
+    {
+        return false;
+    }
+
+    if(dshotBidir)
+    {
+        telemetryDcr = htim->Instance->DCR;
+        __HAL_DMA_DISABLE_IT(&motorsDma, DMA_IT_HT);
+        HAL_NVIC_SetPriority(MOTORS_DMA_IRQ, MOTORS_DMA_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(MOTORS_DMA_IRQ);
+    }
+
+    return true;
+}
+
+static void AnalogInit()
+{
+    float clock = (float)GetTimerClock();
+    const analogProtocol_t* timing = &analogProtocols[motorsProtocol];
+
+    ccrMin = (uint16_t)(timing->minPulse*clock);
+    ccrRange = timing->pulseRange*clock;
+    retrigger = true;
+
+    __HAL_TIM_SET_PRESCALER(htim, 0);
+    __HAL_TIM_SET_AUTORELOAD(htim, (uint32_t)(timing->period*clock)-1);
+    htim->Instance->EGR = TIM_EGR_UG;
+}
+
+static bool IsDshot(motorsProtocol_t protocol)
+{
+    return protocol == MOTORS_PROTOCOL_DSHOT150 ||
+           protocol == MOTORS_PROTOCOL_DSHOT300 ||
+           protocol == MOTORS_PROTOCOL_DSHOT600 ||
+           IsDshotBidir(protocol);
+}
+
+static bool IsDshotBidir(motorsProtocol_t protocol)
+{
+    return protocol == MOTORS_PROTOCOL_DSHOT300_BIDIR ||
+           protocol == MOTORS_PROTOCOL_DSHOT600_BIDIR;
+}
+
+static uint32_t GetTimerClock()
+{
+    /** APB2 timers run at twice the bus clock if APB2 is divided **/
+    uint32_t clock = HAL_RCC_GetPCLK2Freq();
+    if((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1)
+    {
+        clock *= 2;
+    }
+
+    return clock;
+}
+
+static uint16_t DshotPacket(float power)
+{
+    uint16_t throttle = 0;
+
+    if(power > 0)
+    {
+        throttle = DSHOT_THROTTLE_MIN+(uint16_t)(power*(float)(DSHOT_THROTTLE_MAX-DSHOT_THROTTLE_MIN));
+    }
+
+    uint16_t packet = throttle<<1;
+    uint16_t crc = (packet^(packet>>4)^(packet>>8));
+    if(dshotBidir)
+    {
+        crc = ~crc;
+    }
+
+    return (packet<<4)|(crc & 0x0F);
+}
+
+static uint8_t DecodeTelemetry(const uint16_t* samples, uint16_t values[MOTORS_COUNT])
+{
+    uint32_t raw[MOTORS_COUNT] = {0};
+    uint8_t bits[MOTORS_COUNT] = {0};
+    uint16_t runStart[MOTORS_COUNT] = {0};
+    uint8_t started = 0;
+    uint16_t previous = samples[0];
+
+    /** only edges are processed, every run of equal levels adds 1 followed by zeros **/
+    for(uint16_t sample=1; sample<telemetrySampleCount; sample++)
+    {
+        uint16_t changed = (samples[sample]^previous) & MOTORS_GPIO_PINS;
+        previous = samples[sample];
+        if(changed == 0)
+        {
+            continue;
+        }
+
+        for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+        {
+            uint16_t pin = 1U<<(MOTORS_GPIO_PIN_SHIFT+motor);
+            if(!(changed & pin) || bits[motor] > DSHOT_TELEMETRY_BITS)
+            {
+                continue;
+            }
+
+            if(!(started & (1U<<motor)))
+            {
+                /** answer starts with falling edge **/
+                if(!(samples[sample] & pin))
+                {
+                    started |= 1U<<motor;
+                    runStart[motor] = sample;
+                }
+                continue;
+            }
+
+            uint8_t length = (sample-runStart[motor]+DSHOT_TELEMETRY_OVERSAMPLING/2)/DSHOT_TELEMETRY_OVERSAMPLING;
+            if(length == 0)
+            {
+                length = 1;
+            }
+
+            runStart[motor] = sample;
+            raw[motor] = (raw[motor]<<length)|(1U<<(length-1));
+            bits[motor] += length;
+        }
+    }
+
+    uint8_t validMask = 0;
+    for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+    {
+        if(!(started & (1U<<motor)) ||
+           bits[motor] < DSHOT_TELEMETRY_MIN_BITS ||
+           bits[motor] > DSHOT_TELEMETRY_BITS)
+        {
+            continue;
+        }
+
+        /** last run ends at idle level without edge **/
+        uint8_t fill = DSHOT_TELEMETRY_BITS-bits[motor];
+        if(fill > 0)
+        {
+            raw[motor] = (raw[motor]<<fill)|(1U<<(fill-1));
+        }
+
+        uint32_t gcr = raw[motor]^(raw[motor]>>1);
+        uint16_t value = 0;
+        bool gcrValid = true;
+        for(uint8_t nibble=0; nibble<4; nibble++)
+        {
+            uint8_t decoded = gcrDecode[(gcr>>(5*nibble)) & 0x1F];
+            if(decoded == DSHOT_TELEMETRY_INVALID_GCR)
+            {
+                gcrValid = false;
+                break;
+            }
+            value |= decoded<<(4*nibble);
+        }
+
+        uint16_t crc = value^(value>>8);
+        crc ^= crc>>4;
+        if(!gcrValid || (crc & 0x0F) != 0x0F)
+        {
+            continue;
+        }
+
+        values[motor] = value>>4;
+        validMask |= 1U<<motor;
+    }
+
+    return validMask;
+}
+
+static float TelemetryToRpm(uint16_t value)
+{
+    if(value == DSHOT_TELEMETRY_STOPPED)
+    {
+        return 0;
+    }
+
+    uint32_t period = (value & 0x1FFU)<<(value>>9);
+    if(period == 0)
+    {
+        return 0;
+    }
+
+    /** electrical revolution takes period us, rotor turns once every MOTORS_POLES/2 of them **/
+    return 60000000.0f/(float)period*2.0f/(float)MOTORS_POLES;
+}
+
+static void Commit()
+{
+    float power[MOTORS_COUNT];
+
+    for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+    {
+        power[motor] = motorsPower[motor];
+        if(power[motor] > 1)
+        {
+            power[motor] = 1;
+        } else if(power[motor] < 0)
+        {
+            power[motor] = 0;
+        }
+    }
+
+    if(!IsDshot(motorsProtocol))
+    {
+        /** CCRs are preloaded, block update event so all of them change in the same period **/
+        htim->Instance->CR1 |= TIM_CR1_UDIS;
+        for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+        {
+            *(&(htim->Instance->CCR1) + motor) = ((uint16_t)(ccrRange*power[motor]))+ccrMin;
+        }
+        htim->Instance->CR1 &= ~TIM_CR1_UDIS;
+
+        /** restart period now so pulse is synchronous with control loop, never cut running pulse **/
+        if(retrigger && __HAL_TIM_GET_COUNTER(htim) > ((uint32_t)ccrRange)+ccrMin)
+        {
+            htim->Instance->EGR = TIM_EGR_UG;
+        }
+        return;
+    }
+
+    uint16_t packets[MOTORS_COUNT];
+    for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+    {
+        packets[motor] = DshotPacket(power[motor]);
+    }
+
+    /** frame bits can be written only while DMA sends the low gap **/
+    uint32_t row;
+    uint32_t primask;
+    while(1)
+    {
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        if(dshotBidir)
+        {
+            /** stream is sampling answer or still sending low gap before frame **/
+            if(telemetryReceiving)
+            {
+                break;
+            }
+
+            row = DSHOT_FRAME_ROWS-__HAL_DMA_GET_COUNTER(&motorsDma)/MOTORS_COUNT;
+            if(row+DSHOT_SAFE_ROWS < dshotDataRow)
+            {
+                break;
+            }
+        } else
+        {
+            row = DSHOT_FRAME_ROWS-__HAL_DMA_GET_COUNTER(&motorsDma)/MOTORS_COUNT;
+            if(row > DSHOT_FRAME_BITS && row < DSHOT_FRAME_ROWS-DSHOT_SAFE_ROWS)
+            {
+                break;
+            }
+        }
+
+        __set_PRIMASK(primask);
+    }
+
+    for(uint8_t bit=0; bit<DSHOT_FRAME_BITS; bit++)
+    {
+        for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+        {
+            dshotBuffer[dshotDataRow+bit][motor] = (packets[motor] & (0x8000>>bit)) ? dshotBit1 : dshotBit0;
+        }
+    }
+
+    __set_PRIMASK(primask);
+}
@@ -22,22 +22,87 @@ typedef enum{
     MOTORS_FRONT_LEFT,
     MOTORS_BACK_RIGHT,
     MOTORS_FRONT_RIGHT,
+    MOTORS_COUNT
 }motors_t;
 
+typedef enum{
+    MOTORS_PROTOCOL_PWM = 0,    ///< 50Hz 1-2ms servo PWM
+    MOTORS_PROTOCOL_DSHOT150,
+    MOTORS_PROTOCOL_DSHOT300,
+    MOTORS_PROTOCOL_DSHOT600,
+    MOTORS_PROTOCOL_ONESHOT125, ///< 125-250us pulse, 2kHz repeat
+    MOTORS_PROTOCOL_MULTISHOT,  ///< 5-25us pulse, 25kHz repeat
+    MOTORS_PROTOCOL_DSHOT300_BIDIR, ///< inverted DShot300, ESC answers with eRPM on the same pin
+    MOTORS_PROTOCOL_DSHOT600_BIDIR, ///< inverted DShot600, ESC answers with eRPM on the same pin
+    MOTORS_PROTOCOL_COUNT
+}motorsProtocol_t;
+
+/** protocol used when none is stored in remote settings **/
+#ifndef MOTORS_PROTOCOL
+#define MOTORS_PROTOCOL MOTORS_PROTOCOL_PWM
+#endif
+
+/** motor magnet poles, converts electrical rpm from telemetry to rotor rpm **/
+#ifndef MOTORS_POLES
+#define MOTORS_POLES (14U)
+#endif
+
+/**@brief latest bidirectional DShot telemetry **/
+typedef struct{
+    float rpm[MOTORS_COUNT];    ///< [rev/min] rotor speed, valid only if motor bit is set in validMask
+    uint8_t validMask;          ///< bit per motor, set if last answer of that motor was received without errors
+    uint32_t sequence;          ///< incremented with every telemetry window, equal values mean no new data
+}motorsTelemetry_t;
+
 /*****************************************************************************
                          PUBLIC INTERFACE DECLARATION
 *****************************************************************************/
 
-/**@brief starts motor PWM timer
+/**@brief configures motor timer for given protocol and starts it
+ *        DShot frames are repeated continuously by circular update DMA burst into CCR1..CCR4,
+ *        at 4kHz for DShot600, 2kHz for DShot300 and 1kHz for DShot150
+ *        OneShot125 and Multishot pulses are repeated at timer period and retriggered on every commit
+ *        bidirectional DShot frames are sent by normal mode DMA, after every frame motor pins are
+ *        switched to inputs and sampled by the same DMA stream, at about 3kHz for DShot600
+ *        and 1.6kHz for DShot300
  *
  * @param [in] hTim - itmer handle
+ * @param [in] protocol
  * @return true if successful
  */
-bool MotorsInit(TIM_HandleTypeDef* hTim);
+bool MotorsInit(TIM_HandleTypeDef* hTim, motorsProtocol_t protocol);
 
-/**@brief sets power to motor
+/**@brief sets power to motor, other motors keep their values
  *
  * @param [in] motor
  * @param [in] power - range 0:1 == range 0:100%, values outside are set to maximums
  */
 void MotorsSet(motors_t motor, float power);
+
+/**@brief sets power to all motors at once,
+ *        all motors get new values in the same PWM period / DShot frame
+ *        for OneShot125 and Multishot new pulse starts immediately if previous one has ended
+ *
+ * @param [in] power - MOTORS_COUNT values indexed by motors_t, range 0:1,
+ *                     values outside are set to maximums
+ */
+void MotorsSetAll(const float power[MOTORS_COUNT]);
+
+/**@brief decodes latest eRPM answers of all motors,
+ *        call from task context, decoding takes about 2000 cycles
+ *
+ * @param [out] telemetry
+ * @return true if protocol is bidirectional and new telemetry window was received since last call
+ */
+bool MotorsGetTelemetry(motorsTelemetry_t* telemetry);
+
+/**@brief returns last commanded power
+ *
+ * @param [out] power - MOTORS_COUNT values indexed by motors_t, range 0:1
+ */
+void MotorsGetPower(float power[MOTORS_COUNT]);
+
+/**@brief motor DMA stream interrupt, switches motor pins between DShot output and telemetry input
+ *        used only by bidirectional DShot
+ */
+void MotorsDmaIsr();
@@ -10,6 +10,8 @@
 #include "drivers/radio/radio.h"
 #include "drivers/utils/utils.h"
 
+#include "middleware/rcProtocol/rcProtocol.h"
+
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
@@ -22,60 +24,296 @@
 #define PWM_MAX_UP_TIME_S (0.002f)  ///< [s], 50Hz PWM -> 2ms == 10% duty cycle
 #define PWM_MIN_UP_TIME_S (0.001f)  ///< [s], 50Hz PWM -> 1ms == 5% duty cycle
 
+#define ALL_CHANNELS_UPDATED ((1U<<RADIO_CHANNEL_COUNT)-1U)
+
+#define PWM_IN_EXTI_LINES (PWM_IN_1_Pin|PWM_IN_2_Pin|PWM_IN_3_Pin|PWM_IN_4_Pin|PWM_IN_5_Pin|PWM_IN_6_Pin)
+
+/** serial receiver uses USART6 RX (PC7, PWM_IN_6 pin) with DMA2 stream 1 channel 5 **/
+#define RADIO_UART USART6
+#define RADIO_UART_IRQn USART6_IRQn
+#define RADIO_UART_DMA_STREAM DMA2_Stream1
+#define RADIO_UART_DMA_CHANNEL DMA_CHANNEL_5
+#define RADIO_UART_RX_BUFFER_SIZE (128U)    ///< [bytes] needs to hold at least two longest frames
+#define RADIO_UART_ERROR_FLAGS (USART_SR_ORE|USART_SR_NE|USART_SR_FE|USART_SR_PE)
+
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
 *****************************************************************************/
 
-static uint32_t channelStateChangeTime[RADIO_CHANNEL_COUNT] = {0,0,0,0,0,0};
+/**@brief latest complete frame, written only from interrupts
+ *        sequence is odd while frame is being written (seqlock)
+ */
+static volatile struct{
+    uint32_t sequence;
+    uint32_t timestamp;                     ///< DWT cycles
+    uint32_t rawData[RADIO_CHANNEL_COUNT];  ///< PWM: pulse width in DWT cycles, serial: raw 11 bit value
+}frame;
+
+static radioFrameCallback_t frameCallback = NULL;
+
+#if RADIO_RECEIVER == RADIO_RECEIVER_PWM
+
+static volatile uint32_t channelRiseTime[RADIO_CHANNEL_COUNT] = {0};
+static volatile uint32_t channelPulseWidth[RADIO_CHANNEL_COUNT] = {0};
+static volatile uint32_t channelsUpdated = 0;    ///< bit mask of channels with falling edge since last frame
+
+#else
+
+static UART_HandleTypeDef radioUart;
+static DMA_HandleTypeDef radioUartDma;
+
+static uint8_t rxBuffer[RADIO_UART_RX_BUFFER_SIZE];
+static uint32_t rxReadPosition = 0;
 
-/** @brief keeps channel data in range   0..1 **/
-static volatile float channelData[RADIO_CHANNEL_COUNT] = {0,0,0,0,0,0};
+static rcProtocolDecoder_t decoder;
 
-static volatile bool radioSignalAvailable = false;
+#endif
 
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
 
+/**@brief publishes new frame and notifies frame callback,
+ *        can be called only from interrupts that cannot preempt each other
+ *
+ * @param [in] rawData - RADIO_CHANNEL_COUNT raw channel values
+ * @param [in] timestamp - DWT cycles when frame was completed
+ */
+static void PublishFrame(const volatile uint32_t* rawData, uint32_t timestamp);
+
+#if RADIO_RECEIVER != RADIO_RECEIVER_PWM
 
+/**@brief configures USART6 RX pin, DMA and UART for selected protocol
+ *
+ * @return true if successful
+ */
+static bool SerialReceiverInit();
+
+#endif
 
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
 *****************************************************************************/
 
+bool RadioInit()
+{
+#if RADIO_RECEIVER == RADIO_RECEIVER_PWM
+    return true;
+#else
+    /** pins are configured by cube as PWM inputs, serial receiver does not use them **/
+    EXTI->IMR &= ~((uint32_t)PWM_IN_EXTI_LINES);
+    EXTI->PR = PWM_IN_EXTI_LINES;
+
+    return SerialReceiverInit();
+#endif
+}
+
 void RadioIsr(radioChannel_t channel, GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
 {
+#if RADIO_RECEIVER == RADIO_RECEIVER_PWM
+    uint32_t now = DWT->CYCCNT;
+
     if(channel >= RADIO_CHANNEL_COUNT)
     {
         return;
     }
 
-    float timeElapsed = GetTimeElapsed(&channelStateChangeTime[channel], true);
+    if((GPIOx->IDR & GPIO_Pin) != 0)
+    {
+        channelRiseTime[channel] = now;
+        return;
+    }
+
+    channelPulseWidth[channel] = now-channelRiseTime[channel];
+    channelsUpdated |= 1U<<channel;
+
+    if(channelsUpdated == ALL_CHANNELS_UPDATED)
+    {
+        channelsUpdated = 0;
+        PublishFrame(channelPulseWidth, now);
+    }
+#else
+    /** exti of pwm inputs is masked for serial receiver **/
+    (void)channel;
+    (void)GPIOx;
+    (void)GPIO_Pin;
+#endif
+}
+
+void RadioUartIsr()
+{
+#if RADIO_RECEIVER != RADIO_RECEIVER_PWM
+    uint32_t now = DWT->CYCCNT;
+    uint32_t status = RADIO_UART->SR;
 
-    if(0 == HAL_GPIO_ReadPin(GPIOx,GPIO_Pin))
+    /** IDLE and error flags are cleared by reading SR followed by DR **/
+    if((status & (USART_SR_IDLE|RADIO_UART_ERROR_FLAGS)) != 0)
     {
-        channelData[channel] = (timeElapsed-PWM_MIN_UP_TIME_S)/(PWM_MAX_UP_TIME_S-PWM_MIN_UP_TIME_S);
+        (void)RADIO_UART->DR;
+    }
+
+    uint32_t writePosition = RADIO_UART_RX_BUFFER_SIZE-__HAL_DMA_GET_COUNTER(&radioUartDma);
+    if(writePosition >= RADIO_UART_RX_BUFFER_SIZE)
+    {
+        writePosition = 0;
+    }
+
+    while(rxReadPosition != writePosition)
+    {
+        rcProtocolFrame_t decodedFrame;
+        if(RcProtocolFeed(&decoder, rxBuffer[rxReadPosition], &decodedFrame) && !decodedFrame.failsafe)
+        {
+            uint32_t rawData[RADIO_CHANNEL_COUNT];
+            for(uint8_t channel=0; channel<RADIO_CHANNEL_COUNT; channel++)
+            {
+                rawData[channel] = decodedFrame.channels[channel];
+            }
+            PublishFrame(rawData, now);
+        }
+
+        rxReadPosition = (rxReadPosition+1)%RADIO_UART_RX_BUFFER_SIZE;
+    }
 
-        if(channelData[channel] > 1){channelData[channel] = 1;}
-        if(channelData[channel] < 0){channelData[channel] = 0;}
+    /** line idle marks frame boundary **/
+    if((status & (USART_SR_IDLE|RADIO_UART_ERROR_FLAGS)) != 0)
+    {
+        RcProtocolReset(&decoder);
     }
+#endif
+}
 
-    radioSignalAvailable = true;
+void RadioSetFrameCallback(radioFrameCallback_t callback)
+{
+    frameCallback = callback;
 }
 
-radioChannelData_t RadioGetChannelData(radioChannel_t channel)
+bool RadioGetFrame(radioFrame_t* radioFrame)
 {
-    ASSERT(channel < RADIO_CHANNEL_COUNT)
+    RETURN_IF_TRUE(radioFrame == NULL, false)
 
-    radioChannelData_t data = {
-            .channelData = channelData[channel],
-            .lastUpdateTime = channelStateChangeTime[channel]
-    };
+    uint32_t rawData[RADIO_CHANNEL_COUNT];
+    uint32_t sequence;
+
+    /** retry if frame was being written or has changed while copying **/
+    do{
+        sequence = frame.sequence;
+        __DMB();
+
+        radioFrame->timestamp = frame.timestamp;
+        for(uint8_t channel=0; channel<RADIO_CHANNEL_COUNT; channel++)
+        {
+            rawData[channel] = frame.rawData[channel];
+        }
+
+        __DMB();
+    }while((sequence&1U) != 0 || sequence != frame.sequence);
+
+    radioFrame->sequence = sequence/2;
+
+    for(uint8_t channel=0; channel<RADIO_CHANNEL_COUNT; channel++)
+    {
+#if RADIO_RECEIVER == RADIO_RECEIVER_PWM
+        float pulseWidth = ((float)rawData[channel])/((float)SystemCoreClock);
+        float data = (pulseWidth-PWM_MIN_UP_TIME_S)/(PWM_MAX_UP_TIME_S-PWM_MIN_UP_TIME_S);
 
-    return data;
+        if(data > 1){data = 1;}
+        if(data < 0){data = 0;}
+
+        radioFrame->channelData[channel] = data;
+#else
+        radioFrame->channelData[channel] = RcProtocolNormalize((uint16_t)rawData[channel]);
+#endif
+    }
+
+    return true;
 }
 
 /******************************************************************************
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
 
+static void PublishFrame(const volatile uint32_t* rawData, uint32_t timestamp)
+{
+    frame.sequence++;
+    __DMB();
+
+    frame.timestamp = timestamp;
+    for(uint8_t channel=0; channel<RADIO_CHANNEL_COUNT; channel++)
+    {
+        frame.rawData[channel] = rawData[channel];
+    }
+
+    __DMB();
+    frame.sequence++;
+
+    if(frameCallback != NULL)
+    {
+        frameCallback();
+    }
+}
+
+#if RADIO_RECEIVER != RADIO_RECEIVER_PWM
+
+static bool SerialReceiverInit()
+{
+    __HAL_RCC_USART6_CLK_ENABLE();
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    GPIO_InitTypeDef gpio = {
+            .Pin = PWM_IN_6_Pin,
+            .Mode = GPIO_MODE_AF_PP,
+            .Pull = GPIO_PULLUP,
+            .Speed = GPIO_SPEED_FREQ_VERY_HIGH,
+            .Alternate = GPIO_AF8_USART6
+    };
+    HAL_GPIO_Init(PWM_IN_6_GPIO_Port, &gpio);
+
+    radioUartDma.Instance = RADIO_UART_DMA_STREAM;
+    radioUartDma.Init.Channel = RADIO_UART_DMA_CHANNEL;
+    radioUartDma.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    radioUartDma.Init.PeriphInc = DMA_PINC_DISABLE;
+    radioUartDma.Init.MemInc = DMA_MINC_ENABLE;
+    radioUartDma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    radioUartDma.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    radioUartDma.Init.Mode = DMA_CIRCULAR;
+    radioUartDma.Init.Priority = DMA_PRIORITY_HIGH;
+    radioUartDma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    RETURN_IF_FALSE(HAL_DMA_Init(&radioUartDma) == HAL_OK, false)
+
+    __HAL_LINKDMA(&radioUart, hdmarx, radioUartDma);
+
+    radioUart.Instance = RADIO_UART;
+    radioUart.Init.Mode = UART_MODE_RX;
+    radioUart.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    radioUart.Init.OverSampling = UART_OVERSAMPLING_16;
+
+#if RADIO_RECEIVER == RADIO_RECEIVER_SBUS
+    /** SBUS is inverted, F401 USART cannot invert RX so external inverter is needed **/
+    RcProtocolInit(&decoder, RC_PROTOCOL_SBUS);
+    radioUart.Init.BaudRate = RC_PROTOCOL_SBUS_BAUDRATE;
+    radioUart.Init.WordLength = UART_WORDLENGTH_9B;   ///< 8 data bits + parity
+    radioUart.Init.StopBits = UART_STOPBITS_2;
+    radioUart.Init.Parity = UART_PARITY_EVEN;
+#else
+    RcProtocolInit(&decoder, RC_PROTOCOL_CRSF);
+    radioUart.Init.BaudRate = RC_PROTOCOL_CRSF_BAUDRATE;
+    radioUart.Init.WordLength = UART_WORDLENGTH_8B;
+    radioUart.Init.StopBits = UART_STOPBITS_1;
+    radioUart.Init.Parity = UART_PARITY_NONE;
+#endif
+
+    RETURN_IF_FALSE(HAL_UART_Init(&radioUart) == HAL_OK, false)
+    RETURN_IF_FALSE(HAL_UART_Receive_DMA(&radioUart, rxBuffer, RADIO_UART_RX_BUFFER_SIZE) == HAL_OK, false)
+
+    /** received bytes are processed on line idle only, DMA interrupts are not needed **/
+    __HAL_DMA_DISABLE_IT(&radioUartDma, DMA_IT_TC|DMA_IT_HT);
+    __HAL_UART_ENABLE_IT(&radioUart, UART_IT_IDLE);
+
+    HAL_NVIC_SetPriority(RADIO_UART_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(RADIO_UART_IRQn);
+
+    return true;
+}
+
+#endif
@@ -16,6 +16,15 @@
                        PUBLIC DEFINES / MACROS / ENUMS
 *****************************************************************************/
 
+/** receiver types **/
+#define RADIO_RECEIVER_PWM  (0U)    ///< 6 separate PWM lines on PWM_IN_1..6 pins
+#define RADIO_RECEIVER_SBUS (1U)    ///< serial receiver on PWM_IN_6 pin (USART6 RX), needs external inverter
+#define RADIO_RECEIVER_CRSF (2U)    ///< serial receiver on PWM_IN_6 pin (USART6 RX)
+
+#ifndef RADIO_RECEIVER
+#define RADIO_RECEIVER RADIO_RECEIVER_PWM
+#endif
+
 typedef enum{
     RADIO_CHANNEL_1,
     RADIO_CHANNEL_2,
@@ -23,20 +32,45 @@ typedef enum{
     RADIO_CHANNEL_4,
     RADIO_CHANNEL_5,
     RADIO_CHANNEL_6,
+#if RADIO_RECEIVER != RADIO_RECEIVER_PWM
+    RADIO_CHANNEL_7,
+    RADIO_CHANNEL_8,
+    RADIO_CHANNEL_9,
+    RADIO_CHANNEL_10,
+    RADIO_CHANNEL_11,
+    RADIO_CHANNEL_12,
+    RADIO_CHANNEL_13,
+    RADIO_CHANNEL_14,
+    RADIO_CHANNEL_15,
+    RADIO_CHANNEL_16,
+#endif
     RADIO_CHANNEL_COUNT
 }radioChannel_t;
 
+/**@brief complete radio frame, all channels come from the same receiver frame **/
 typedef struct{
-    float channelData;
-    uint32_t lastUpdateTime;
-}radioChannelData_t;
+    uint32_t sequence;                          ///< incremented with every received frame
+    uint32_t timestamp;                         ///< DWT cycle counter value when frame was received
+    float channelData[RADIO_CHANNEL_COUNT];     ///< 0..1
+}radioFrame_t;
+
+/**@brief called from interrupt context whenever new frame is published **/
+typedef void (*radioFrameCallback_t)(void);
 
 /*****************************************************************************
                          PUBLIC INTERFACE DECLARATION
 *****************************************************************************/
 
+/**@brief initializes serial receiver, does nothing for PWM receiver
+ *
+ * @return true if successful
+ */
+bool RadioInit();
+
 /**@brief needs to be called when rising or falling interrupt on each radio channel arrives
- *        interrupt needs to be cleared only when this function for each channel is executed
+ *        interrupt flag should be cleared before calling it, so an edge arriving
+ *        during the call is not lost
+ *        only stores raw cycle counter value, pulse width is normalized in RadioGetFrame
  *
  * @param [in] channel
  * @param [in] GPIOx - GPIO port
@@ -44,11 +78,22 @@ typedef struct{
  */
 void RadioIsr(radioChannel_t channel, GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
 
-/**@brief getter for radio channel data and last update time
- *        asserts if channel is invalid
+/**@brief needs to be called from serial receiver UART interrupt,
+ *        decodes all bytes received by DMA since last call
+ */
+void RadioUartIsr();
+
+/**@brief sets function called from interrupt when new complete frame is received
+ *        for PWM receiver frame is complete when every channel has received a pulse
  *
- * @param [in] channel
- * @return radio channel data and last update time
+ * @param [in] callback - needs to be interrupt safe, NULL disables it
  */
-radioChannelData_t RadioGetChannelData(radioChannel_t channel);
+void RadioSetFrameCallback(radioFrameCallback_t callback);
 
+/**@brief copies latest complete frame, lock free
+ *        converts raw pulse widths / serial values to range 0..1
+ *
+ * @param [out] radioFrame
+ * @return true if successful
+ */
+bool RadioGetFrame(radioFrame_t* radioFrame);
@@ -10,6 +10,7 @@
 
 #include "drivers/uart/uart.h"
 #include "drivers/utils/utils.h"
+#include "cmsis_os.h"
 
 #include <string.h>
 #include <stdarg.h>
@@ -25,6 +26,12 @@
 #define PRECISION_SIGNIFICANT_DIGITS (6U)   ///< needs to be  compatible with PRECISION_MULTIPLICATOR
 #define PRECISION_MULTIPLICATOR (1000000U)  ///< = 10^PRECISION_SIGNIFICANT_DIGITS
 
+/** USART1 RX uses DMA2 stream 2 channel 4, stream 5 is taken by motors **/
+#define UART_RX_DMA_STREAM DMA2_Stream2
+#define UART_RX_DMA_CHANNEL DMA_CHANNEL_4
+#define UART_IRQn USART1_IRQn
+#define UART_ERROR_FLAGS (USART_SR_ORE|USART_SR_NE|USART_SR_FE|USART_SR_PE)
+
 
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
@@ -32,12 +39,29 @@
 
 static UART_HandleTypeDef *uartHandle;
 
+static DMA_HandleTypeDef uartRxDma;
+static uint8_t rxBuffer[UART_RX_BUFFER_SIZE];
+static uint32_t rxReadPosition = 0;
+static uartRxCallback_t rxCallback = NULL;
+
 static const char messageTooLongErrMsg[] = "Message too long\r\n";
 
+/** text reports and config protocol responses share USART1, whole messages are sent under lock **/
+static StaticSemaphore_t txMutexBuffer;
+static SemaphoreHandle_t txMutex = NULL;
+
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
 
+/**@brief sends bytes in blocking mode, holds tx lock once scheduler is running
+ *
+ * @param [in] data
+ * @param [in] size
+ * @return true if successful
+ */
+static bool Transmit(const uint8_t* data, uint16_t size);
+
 /**@brief disects double into two integers
  *        1-st int - digits before comma
  *        2-nd int log10(PRECISION_MULTIPLICATOR) amount of digits after comma
@@ -103,17 +127,15 @@ uint32_t Vsprintf(char* buffer, char format[], va_list args);
 bool UartInit(UART_HandleTypeDef *uh)
 {
     uartHandle = uh;
-    return true;
+    txMutex = xSemaphoreCreateMutexStatic(&txMutexBuffer);
+    return txMutex != NULL;
 }
 
 bool UartWrite(char *format, ...)
 {
     if(strlen(format) > UART_MAX_MESSAGE_SIZE)
     {
-        if(HAL_UART_Transmit(uartHandle, (uint8_t*)messageTooLongErrMsg, strlen(messageTooLongErrMsg), 1000) != HAL_OK)
-        {
-            return false;
-        }
+        Transmit((const uint8_t*)messageTooLongErrMsg, strlen(messageTooLongErrMsg));
         return false;
     }
 
@@ -124,18 +146,115 @@ bool UartWrite(char *format, ...)
     ASSERT(msgSize <= UART_MAX_MESSAGE_SIZE)
     va_end(aptr);
 
-    if(HAL_UART_Transmit(uartHandle, (uint8_t*)buffer, msgSize, 1000) != HAL_OK)
+    return Transmit((const uint8_t*)buffer, msgSize);
+}
+
+
+bool UartWriteBytes(const uint8_t* data, uint16_t size)
+{
+    RETURN_IF_TRUE(data == NULL, false)
+
+    return Transmit(data, size);
+}
+
+bool UartStartReceive(uartRxCallback_t callback)
+{
+    RETURN_IF_TRUE(uartHandle == NULL, false)
+
+    rxCallback = callback;
+    rxReadPosition = 0;
+
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    uartRxDma.Instance = UART_RX_DMA_STREAM;
+    uartRxDma.Init.Channel = UART_RX_DMA_CHANNEL;
+    uartRxDma.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    uartRxDma.Init.PeriphInc = DMA_PINC_DISABLE;
+    uartRxDma.Init.MemInc = DMA_MINC_ENABLE;
+    uartRxDma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    uartRxDma.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    uartRxDma.Init.Mode = DMA_CIRCULAR;
+    uartRxDma.Init.Priority = DMA_PRIORITY_LOW;
+    uartRxDma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    RETURN_IF_FALSE(HAL_DMA_Init(&uartRxDma) == HAL_OK, false)
+
+    __HAL_LINKDMA(uartHandle, hdmarx, uartRxDma);
+
+    RETURN_IF_FALSE(HAL_UART_Receive_DMA(uartHandle, rxBuffer, UART_RX_BUFFER_SIZE) == HAL_OK, false)
+
+    /** bytes are taken out of buffer by reader, DMA interrupts are not needed **/
+    __HAL_DMA_DISABLE_IT(&uartRxDma, DMA_IT_TC|DMA_IT_HT);
+    __HAL_UART_ENABLE_IT(uartHandle, UART_IT_IDLE);
+
+    HAL_NVIC_SetPriority(UART_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(UART_IRQn);
+
+    return true;
+}
+
+uint32_t UartRead(uint8_t* data, uint32_t maxSize)
+{
+    RETURN_IF_TRUE(data == NULL, 0)
+
+    uint32_t writePosition = UART_RX_BUFFER_SIZE-__HAL_DMA_GET_COUNTER(&uartRxDma);
+    if(writePosition >= UART_RX_BUFFER_SIZE)
     {
-        return false;
+        writePosition = 0;
     }
-    return true;
+
+    uint32_t count = 0;
+    while(rxReadPosition != writePosition && count < maxSize)
+    {
+        data[count] = rxBuffer[rxReadPosition];
+        rxReadPosition = (rxReadPosition+1)%UART_RX_BUFFER_SIZE;
+        count++;
+    }
+
+    return count;
 }
 
+void UartIsr()
+{
+    uint32_t status = uartHandle->Instance->SR;
+
+    /** IDLE and error flags are cleared by reading SR followed by DR **/
+    if((status & (USART_SR_IDLE|UART_ERROR_FLAGS)) == 0)
+    {
+        return;
+    }
+    (void)uartHandle->Instance->DR;
+
+    if(rxCallback != NULL)
+    {
+        rxCallback();
+    }
+}
 
 /******************************************************************************
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
 
+static bool Transmit(const uint8_t* data, uint16_t size)
+{
+    RETURN_IF_TRUE(uartHandle == NULL, false)
+
+    /** init reports are sent before scheduler starts, single context then **/
+    bool locked = xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+    if(locked)
+    {
+        xSemaphoreTake(txMutex, portMAX_DELAY);
+    }
+
+    bool result = HAL_UART_Transmit(uartHandle, (uint8_t*)data, size, 1000) == HAL_OK;
+
+    if(locked)
+    {
+        xSemaphoreGive(txMutex);
+    }
+
+    return result;
+}
+
 void DoubleToTwoInts(double d, uint32_t* wholes, uint32_t* parts, bool *bellow_0)
 {
     if(wholes == NULL || parts == NULL)
@@ -22,6 +22,12 @@
 #define UART_MAX_MESSAGE_SIZE 100
 #endif
 
+#define UART_RX_BUFFER_SIZE (512U)  ///< [bytes] circular DMA buffer, needs to hold at least two longest requests
+
+/**@brief called from interrupt when line goes idle after received bytes
+ */
+typedef void (*uartRxCallback_t)(void);
+
 /*****************************************************************************
                          PUBLIC INTERFACE DECLARATION
 *****************************************************************************/
@@ -33,10 +39,38 @@
  */
 bool UartInit(UART_HandleTypeDef *uh);
 
-/**@brief writes data to uart, formatting the same as in printf
+/**@brief writes data to uart, formatting the same as in printf,
+ *        message is sent whole under tx lock, do not call from interrupt
  *
  * @param format
  * @return true if success
  */
 bool UartWrite(char *format, ...);
 
+/**@brief writes raw bytes to uart,
+ *        message is sent whole under tx lock, do not call from interrupt
+ *
+ * @param [in] data
+ * @param [in] size
+ * @return true if success
+ */
+bool UartWriteBytes(const uint8_t* data, uint16_t size);
+
+/**@brief starts circular DMA reception (DMA2 stream 2 channel 4) with idle line interrupt
+ *
+ * @param [in] callback - called from interrupt on idle line, can be NULL
+ * @return true if success
+ */
+bool UartStartReceive(uartRxCallback_t callback);
+
+/**@brief copies bytes received since last call
+ *
+ * @param [out] data
+ * @param [in] maxSize
+ * @return count of bytes copied
+ */
+uint32_t UartRead(uint8_t* data, uint32_t maxSize);
+
+/**@brief uart interrupt handler, call from USART1_IRQHandler
+ */
+void UartIsr();
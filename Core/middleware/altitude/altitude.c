@@ -10,30 +10,57 @@
 #include "drivers/LPS/LPS.h"
 
 #include "middleware/altitude/altitude.h"
-#include "middleware/digitalFilter/digitalFilter.h"
+#include "middleware/verticalEstimator/verticalEstimator.h"
 
 #include "cmsis_os.h"
 /*****************************************************************************
                           PRIVATE DEFINES / MACROS
 *****************************************************************************/
 
-#define HPA_IN_1M (10.0f)
+#define ALTITUDE_GAS_CONSTANT (287.05f)    ///< specific gas constant of dry air [J/(kg*K)]
+#define ALTITUDE_GRAVITY (9.80665f)         ///< [m/s^2]
+#define ALTITUDE_LAPSE_RATE (0.0065f)       ///< ISA temperature lapse rate [K/m]
+#define ALTITUDE_KELVIN (273.15f)
+
+#define ALTITUDE_CALIBRATION_SAMPLES (25U)  ///< 1s of baro samples averaged for ground reference
+
+#define ALTITUDE_MAX_SAMPLES (8U)     ///< older samples are dropped after long stall, keeps task stack small
+#define ALTITUDE_BARO_PERIOD_MS (2U*LPS_ODR_PERIOD_MS)   ///< [ms] fifo polling period, two samples per read
 
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
 *****************************************************************************/
 
-static digitalFilterHandle_t pressureFilterHandle;
+static float homePressure = 1013.25f;   ///< [hPa]
+static float homeTemperature = 15.0f;   ///< [deg C]
+
+static volatile float peakAcceleration = 0;    ///< [m/s^2] max vertical acceleration since last read
 
-static float homePressure = 1000.0f; ///< [hPa]
+static uint32_t lastSampleTimestamp = 0;   ///< [ms] of last baro sample used for correction
 
-static float currentPressure = 1000.0f; ///< [hPa]
+static volatile bool calibrationRequested = true;
+static volatile bool calibrated = false;
+static uint32_t calibrationCount = 0;
+static float calibrationPressureSum = 0.0f;
+static float calibrationTemperatureSum = 0.0f;
 
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
 
+/**@brief corrects vertical estimator with single baro sample and runs ground calibration if requested
+ *
+ * @param [in] sample
+ */
+static void ProcessSample(const lpsSample_t* sample);
 
+/**@brief natural logarithm for arguments close to 1
+ *        atanh series, relative error below 1e-6 for 0.7 < x < 1.5
+ *
+ * @param [in] x
+ * @return ln(x)
+ */
+static float FastLn(float x);
 
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
@@ -41,40 +68,135 @@ static float currentPressure = 1000.0f; ///< [hPa]
 
 bool AltitudeInit()
 {
-    /** 0.3Hz low pass filter with fs = 25Hz **/
-    float numerator[3] = {0.001348711948356, 0.002697423896713, 0.001348711948356};
-    float denominator[3] = {1, -1.89346414636182, 0.898858994155252};
-
-    if(!DigitalFilterCreateFilter(numerator, denominator, 2, &pressureFilterHandle))
-    {
-        return false;
-    }
+    VerticalEstimatorReset(0.0f);
     return true;
 }
 
 void AltitudeTask()
 {
-    homePressure = LPSGetPressure();
-
-    uint32_t previousWakeTime = osKernelSysTick();
+    lpsSample_t samples[ALTITUDE_MAX_SAMPLES];
+    TickType_t lastWakeTime = xTaskGetTickCount();
     while(1)
     {
-        DigitalFilterProcess(pressureFilterHandle, LPSGetPressure(), &currentPressure);
+        /** barometer INT_DRDY is not routed to MCU, fifo is polled **/
+        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(ALTITUDE_BARO_PERIOD_MS));
+
+        uint8_t count = LPSReadSamples(samples, ALTITUDE_MAX_SAMPLES);
+        for(uint8_t i=0; i<count; i++)
+        {
+            ProcessSample(&samples[i]);
+        }
+    }
+}
 
-        osDelayUntil(&previousWakeTime,50);
+void AltitudeUpdateAcceleration(float acceleration, float dt)
+{
+    /** called from highest priority task, baro correction and getters never preempt it **/
+    VerticalEstimatorPredict(acceleration, dt, HAL_GetTick());
+
+    if(acceleration > peakAcceleration)
+    {
+        peakAcceleration = acceleration;
     }
 }
 
 float AltitudeGetAltitudeFromHome()
 {
-    return (homePressure-currentPressure)*HPA_IN_1M;
+    verticalState_t state;
+    taskENTER_CRITICAL();
+    VerticalEstimatorGetState(&state);
+    taskEXIT_CRITICAL();
+
+    return state.altitude;
+}
+
+float AltitudeGetClimbRate()
+{
+    verticalState_t state;
+    taskENTER_CRITICAL();
+    VerticalEstimatorGetState(&state);
+    taskEXIT_CRITICAL();
+
+    return state.climbRate;
 }
 
 void AltitudeSetHome()
 {
-    homePressure = currentPressure;
+    calibrationRequested = true;
+}
+
+float AltitudeGetPeakAcceleration()
+{
+    float peak = peakAcceleration;
+    peakAcceleration = 0;
+
+    return peak;
+}
+
+bool AltitudeIsCalibrated()
+{
+    return calibrated && !calibrationRequested;
+}
+
+float AltitudeFromPressure(float pressure, float groundPressure, float groundTemperature)
+{
+    if(pressure <= 0.0f || groundPressure <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    /** hypsometric equation h = R*Tm/g*ln(p0/p) with mean layer temperature
+     *  Tm = T0 - L*h/2 following ISA lapse rate, solved for h **/
+    float k = ALTITUDE_GAS_CONSTANT/ALTITUDE_GRAVITY*FastLn(groundPressure/pressure);
+    return k*(groundTemperature+ALTITUDE_KELVIN)/(1.0f + 0.5f*ALTITUDE_LAPSE_RATE*k);
 }
 /******************************************************************************
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
 
+static void ProcessSample(const lpsSample_t* sample)
+{
+    if(calibrated)
+    {
+        float dt = (float)(sample->timestamp-lastSampleTimestamp)*0.001f;
+        float baroAltitude = AltitudeFromPressure(sample->pressure, homePressure, homeTemperature);
+
+        taskENTER_CRITICAL();
+        VerticalEstimatorCorrect(baroAltitude, dt, sample->timestamp);
+        taskEXIT_CRITICAL();
+    }
+    lastSampleTimestamp = sample->timestamp;
+
+    if(calibrationRequested)
+    {
+        calibrationRequested = false;
+        calibrationCount = 0;
+        calibrationPressureSum = 0.0f;
+        calibrationTemperatureSum = 0.0f;
+    }
+
+    if(calibrationCount < ALTITUDE_CALIBRATION_SAMPLES)
+    {
+        calibrationPressureSum += sample->pressure;
+        calibrationTemperatureSum += sample->temperature;
+        calibrationCount++;
+
+        if(calibrationCount == ALTITUDE_CALIBRATION_SAMPLES)
+        {
+            homePressure = calibrationPressureSum/(float)ALTITUDE_CALIBRATION_SAMPLES;
+            homeTemperature = calibrationTemperatureSum/(float)ALTITUDE_CALIBRATION_SAMPLES;
+            calibrated = true;
+
+            taskENTER_CRITICAL();
+            VerticalEstimatorReset(0.0f);
+            taskEXIT_CRITICAL();
+        }
+    }
+}
+
+static float FastLn(float x)
+{
+    float y = (x-1.0f)/(x+1.0f);
+    float y2 = y*y;
+    return 2.0f*y*(1.0f + y2*(1.0f/3.0f + y2*(1.0f/5.0f + y2*(1.0f/7.0f))));
+}
@@ -21,7 +21,7 @@
                          PUBLIC INTERFACE DECLARATION
 *****************************************************************************/
 
-/**@brief initializes altitude filter
+/**@brief initializes vertical estimator
  *
  * @return true if successful
  */
@@ -31,12 +31,50 @@ bool AltitudeInit();
  */
 void AltitudeTask();
 
+/**@brief propagates vertical estimator, call at IMU rate
+ *
+ * @param [in] acceleration - [m/s^2] earth frame vertical acceleration without gravity, up is positive
+ * @param [in] dt - [s] time since last call
+ */
+void AltitudeUpdateAcceleration(float acceleration, float dt);
+
 /**@brief returns distance in height between current position and home position
+ *        baro and accelerometer fusion
  *
  * @return distance [m]
  */
 float AltitudeGetAltitudeFromHome();
 
-/**@brief sets current height as position
+/**@brief returns vertical speed
+ *
+ * @return climb rate [m/s], up is positive
+ */
+float AltitudeGetClimbRate();
+
+/**@brief returns max upward acceleration since last call and resets it,
+ *        short impacts are not missed by slower tasks
+ *
+ * @return acceleration [m/s^2], up is positive
+ */
+float AltitudeGetPeakAcceleration();
+
+/**@brief starts ground reference calibration, pressure and temperature
+ *        are averaged over next second of baro samples
  */
 void AltitudeSetHome();
+
+/**@brief checks if ground reference calibration is finished
+ *
+ * @return true if calibrated
+ */
+bool AltitudeIsCalibrated();
+
+/**@brief converts pressure to height above reference point using hypsometric
+ *        equation with ISA temperature lapse rate
+ *
+ * @param [in] pressure - [hPa]
+ * @param [in] groundPressure - pressure at reference point [hPa]
+ * @param [in] groundTemperature - temperature at reference point [deg C]
+ * @return height above reference point [m]
+ */
+float AltitudeFromPressure(float pressure, float groundPressure, float groundTemperature);
@@ -0,0 +1,122 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/altitudeHold/altitudeHold.c
+ *
+ * @brief Source code
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/altitudeHold/altitudeHold.h"
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define STICK_CENTER (0.5f)
+#define STICK_DEADBAND (0.1f)           ///< stick deviation from center that holds altitude
+
+#define ALTITUDE_GAIN (1.0f)            ///< [1/s] altitude error to climb rate
+#define CLIMB_RATE_GAIN (0.15f)         ///< [1/(m/s)] climb rate error to throttle
+#define HOVER_LEARNING_GAIN (0.05f)     ///< [1/m] climb rate error integrated into hover throttle
+
+#define HOVER_THROTTLE_MIN (0.2f)
+#define HOVER_THROTTLE_MAX (0.8f)
+#define HOVER_THROTTLE_DEFAULT (0.5f)
+
+#define MAX_ALTITUDE_ERROR (2.0f)       ///< [m] target is dragged along if error is bigger, limits climb after pushes
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+static float targetAltitude = 0;            ///< [m]
+static float hoverThrottle = HOVER_THROTTLE_DEFAULT;
+static bool hoverThrottleLearned = false;
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief limits value to given range
+ *
+ * @param [in] value
+ * @param [in] min
+ * @param [in] max
+ * @return limited value
+ */
+static float Constrain(float value, float min, float max);
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+void AltitudeHoldReset(float altitude, float throttle)
+{
+    targetAltitude = altitude;
+
+    if(!hoverThrottleLearned)
+    {
+        hoverThrottle = Constrain(throttle, HOVER_THROTTLE_MIN, HOVER_THROTTLE_MAX);
+        hoverThrottleLearned = true;
+    }
+}
+
+float AltitudeHoldStickToClimbRate(float stick)
+{
+    float deviation = stick-STICK_CENTER;
+
+    if(deviation > STICK_DEADBAND)
+    {
+        return (deviation-STICK_DEADBAND)/(1.0f-STICK_CENTER-STICK_DEADBAND)*ALTITUDE_HOLD_MAX_CLIMB_RATE;
+    } else if(deviation < -STICK_DEADBAND)
+    {
+        return (deviation+STICK_DEADBAND)/(STICK_CENTER-STICK_DEADBAND)*ALTITUDE_HOLD_MAX_DESCENT_RATE;
+    }
+    return 0;
+}
+
+float AltitudeHoldUpdate(float climbRate, float altitude, float measuredClimbRate, float dt)
+{
+    /** target moves with commanded climb rate, altitude loop only removes drift **/
+    targetAltitude += climbRate*dt;
+    targetAltitude = Constrain(targetAltitude, altitude-MAX_ALTITUDE_ERROR, altitude+MAX_ALTITUDE_ERROR);
+
+    float climbRateTarget = climbRate + ALTITUDE_GAIN*(targetAltitude-altitude);
+    climbRateTarget = Constrain(climbRateTarget, -ALTITUDE_HOLD_MAX_DESCENT_RATE, ALTITUDE_HOLD_MAX_CLIMB_RATE);
+
+    float climbRateError = climbRateTarget-measuredClimbRate;
+
+    /** integral part of climb rate loop is the hover throttle itself **/
+    hoverThrottle += HOVER_LEARNING_GAIN*climbRateError*dt;
+    hoverThrottle = Constrain(hoverThrottle, HOVER_THROTTLE_MIN, HOVER_THROTTLE_MAX);
+
+    return Constrain(hoverThrottle + CLIMB_RATE_GAIN*climbRateError, ALTITUDE_HOLD_MIN_THROTTLE, 1.0f);
+}
+
+float AltitudeHoldGetHoverThrottle()
+{
+    return hoverThrottle;
+}
+
+bool AltitudeHoldIsHoverLearned()
+{
+    return hoverThrottleLearned;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static float Constrain(float value, float min, float max)
+{
+    if(value < min)
+    {
+        return min;
+    }
+    if(value > max)
+    {
+        return max;
+    }
+    return value;
+}
@@ -0,0 +1,62 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/altitudeHold/altitudeHold.h
+ *
+ * @brief Header file
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define ALTITUDE_HOLD_MAX_CLIMB_RATE (2.0f)     ///< [m/s] at full throttle stick
+#define ALTITUDE_HOLD_MAX_DESCENT_RATE (1.5f)   ///< [m/s] at zero throttle stick
+#define ALTITUDE_HOLD_MIN_THROTTLE (0.1f)       ///< output floor, above idle threshold of device manager (0.05)
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief engages altitude hold, target altitude is set to current one,
+ *        hover throttle is initialized with current throttle if not learned yet
+ *
+ * @param [in] altitude - [m] current altitude
+ * @param [in] throttle - current throttle 0..1, used for bumpless transfer
+ */
+void AltitudeHoldReset(float altitude, float throttle);
+
+/**@brief converts throttle stick to climb rate command,
+ *        stick around center holds altitude
+ *
+ * @param [in] stick - throttle stick 0..1
+ * @return climb rate [m/s]
+ */
+float AltitudeHoldStickToClimbRate(float stick);
+
+/**@brief runs altitude / climb rate cascade, learns hover throttle
+ *
+ * @param [in] climbRate - [m/s] commanded climb rate, 0 holds altitude
+ * @param [in] altitude - [m] estimated altitude
+ * @param [in] measuredClimbRate - [m/s] estimated climb rate
+ * @param [in] dt - [s] time since last call
+ * @return throttle ALTITUDE_HOLD_MIN_THROTTLE..1, motors never go idle in flight
+ */
+float AltitudeHoldUpdate(float climbRate, float altitude, float measuredClimbRate, float dt);
+
+/**@brief getter for learned hover throttle
+ *
+ * @return throttle 0..1, kept between flights
+ */
+float AltitudeHoldGetHoverThrottle();
+
+/**@brief checks if hover throttle was learned in flight
+ *
+ * @return true if altitude hold was engaged since power up
+ */
+bool AltitudeHoldIsHoverLearned();
@@ -0,0 +1,214 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/autoLand/autoLand.c
+ *
+ * @brief Source code
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/autoLand/autoLand.h"
+#include "middleware/altitudeHold/altitudeHold.h"
+
+#include <stddef.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define LEVEL_ATTITUDE_ERROR (0.17f)    ///< [rad] roll/pitch error treated as level
+#define LEVEL_MIN_TIME (0.5f)           ///< [s] attitude has to settle this long
+#define LEVEL_MAX_TIME (2.0f)           ///< [s] descent starts even if attitude is not level
+
+#define DESCENT_ESTABLISHED_RATE (0.5f*AUTO_LAND_DESCENT_RATE)  ///< [m/s] touchdown is not detected before reaching it
+#define DESCENT_SETTLE_TIME (3.0f)      ///< [s] touchdown detection starts anyway, when failsafe started on ground
+
+#define TOUCHDOWN_CLIMB_RATE (0.2f)     ///< [m/s] slower descent with throttle below hover means ground contact
+#define TOUCHDOWN_TIME (1.0f)           ///< [s] descent has to be stalled this long
+#define TOUCHDOWN_IMPACT (15.0f)        ///< [m/s^2] upward acceleration peak of ground impact
+
+#define OPEN_LOOP_THROTTLE (0.95f)      ///< part of hover throttle used without altitude estimate, ~1.5m/s descent
+#define OPEN_LOOP_MAX_TIME (30.0f)      ///< [s] open loop descent is treated as landed after this time
+
+#define SPOOL_DOWN_TIME (0.5f)          ///< [s] throttle ramp to 0 after touchdown
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+static autoLandPhase_t phase = AUTO_LAND_LANDED;
+static float phaseTime = 0;         ///< [s] time in current phase
+static float levelTime = 0;         ///< [s] time with level attitude
+static float stallTime = 0;         ///< [s] time with stalled descent
+static bool descentEstablished = false;
+static float hoverThrottle = 0;     ///< hover estimate given at failsafe start
+static float throttle = 0;          ///< last output
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief changes phase and resets phase timer
+ *
+ * @param [in] nextPhase
+ */
+static void SetPhase(autoLandPhase_t nextPhase);
+
+/**@brief checks ground contact during descent
+ *
+ * @param [in] input
+ * @param [in] dt - [s]
+ * @return true if touchdown was detected
+ */
+static bool TouchdownDetected(const autoLandInput_t* input, float dt);
+
+/**@brief keeps throttle above idle while airborne, flight controller keeps attitude control then
+ *
+ * @param [in] value - throttle 0..1
+ * @return throttle ALTITUDE_HOLD_MIN_THROTTLE..1
+ */
+static float MinFlightThrottle(float value);
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+void AutoLandStart(float altitude, float hoverEstimate, bool airborne)
+{
+    hoverThrottle = hoverEstimate;
+    throttle = hoverEstimate;
+    descentEstablished = false;
+    levelTime = 0;
+    stallTime = 0;
+
+    /** altitude hold would spin motors up to hover throttle and hop off the ground **/
+    if(!airborne)
+    {
+        throttle = 0;
+        SetPhase(AUTO_LAND_LANDED);
+        return;
+    }
+
+    AltitudeHoldReset(altitude, hoverEstimate);
+    SetPhase(AUTO_LAND_LEVEL);
+}
+
+float AutoLandUpdate(const autoLandInput_t* input, float dt)
+{
+    if(input == NULL)
+    {
+        return 0;
+    }
+
+    phaseTime += dt;
+
+    switch(phase)
+    {
+    case AUTO_LAND_LEVEL:
+        if(input->estimateValid)
+        {
+            throttle = AltitudeHoldUpdate(0, input->altitude, input->climbRate, dt);
+        }
+        throttle = MinFlightThrottle(throttle);
+
+        if(input->attitudeError > LEVEL_ATTITUDE_ERROR)
+        {
+            levelTime = 0;
+        } else
+        {
+            levelTime += dt;
+        }
+
+        if(levelTime >= LEVEL_MIN_TIME || phaseTime >= LEVEL_MAX_TIME)
+        {
+            SetPhase(AUTO_LAND_DESCENT);
+        }
+        break;
+
+    case AUTO_LAND_DESCENT:
+        if(input->estimateValid)
+        {
+            throttle = AltitudeHoldUpdate(-AUTO_LAND_DESCENT_RATE, input->altitude, input->climbRate, dt);
+        } else
+        {
+            throttle = OPEN_LOOP_THROTTLE*hoverThrottle;
+        }
+        throttle = MinFlightThrottle(throttle);
+
+        if(TouchdownDetected(input, dt))
+        {
+            SetPhase(AUTO_LAND_TOUCHDOWN);
+        }
+        break;
+
+    case AUTO_LAND_TOUCHDOWN:
+        throttle -= hoverThrottle*dt/SPOOL_DOWN_TIME;
+        if(throttle <= 0)
+        {
+            throttle = 0;
+            SetPhase(AUTO_LAND_LANDED);
+        }
+        break;
+
+    case AUTO_LAND_LANDED:
+    default:
+        throttle = 0;
+        break;
+    }
+
+    return throttle;
+}
+
+autoLandPhase_t AutoLandGetPhase()
+{
+    return phase;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static void SetPhase(autoLandPhase_t nextPhase)
+{
+    phase = nextPhase;
+    phaseTime = 0;
+}
+
+static float MinFlightThrottle(float value)
+{
+    return value < ALTITUDE_HOLD_MIN_THROTTLE ? ALTITUDE_HOLD_MIN_THROTTLE : value;
+}
+
+static bool TouchdownDetected(const autoLandInput_t* input, float dt)
+{
+    if(!input->estimateValid)
+    {
+        return input->peakAcceleration > TOUCHDOWN_IMPACT || phaseTime >= OPEN_LOOP_MAX_TIME;
+    }
+
+    if(input->climbRate < -DESCENT_ESTABLISHED_RATE || phaseTime >= DESCENT_SETTLE_TIME)
+    {
+        descentEstablished = true;
+    }
+
+    if(!descentEstablished)
+    {
+        return false;
+    }
+
+    if(input->peakAcceleration > TOUCHDOWN_IMPACT)
+    {
+        return true;
+    }
+
+    /** controller pushes below hover but aircraft does not descend, it is on the ground **/
+    if(input->climbRate > -TOUCHDOWN_CLIMB_RATE && throttle < AltitudeHoldGetHoverThrottle())
+    {
+        stallTime += dt;
+    } else
+    {
+        stallTime = 0;
+    }
+
+    return stallTime >= TOUCHDOWN_TIME;
+}
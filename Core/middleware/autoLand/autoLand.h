@@ -0,0 +1,62 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/autoLand/autoLand.h
+ *
+ * @brief Header file
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define AUTO_LAND_DESCENT_RATE (0.7f)   ///< [m/s]
+
+typedef enum{
+    AUTO_LAND_LEVEL = 0,    ///< holding altitude until attitude is level
+    AUTO_LAND_DESCENT,      ///< descending with constant rate
+    AUTO_LAND_TOUCHDOWN,    ///< ground contact detected, throttle ramps down
+    AUTO_LAND_LANDED        ///< throttle is 0, ready to disarm
+}autoLandPhase_t;
+
+/**@brief auto land inputs, sampled every update **/
+typedef struct{
+    float altitude;         ///< [m] estimated altitude
+    float climbRate;        ///< [m/s] estimated climb rate, up is positive
+    float peakAcceleration; ///< [m/s^2] max vertical acceleration since last update
+    float attitudeError;    ///< [rad] roll/pitch distance from level target
+    bool estimateValid;     ///< false if altitude estimate cannot be used, descent is open loop
+}autoLandInput_t;
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief starts landing sequence
+ *
+ * @param [in] altitude - [m] current altitude
+ * @param [in] hoverEstimate - hover throttle 0..1, learned by altitude hold or configured,
+ *                             open loop descent throttle is derived from it
+ * @param [in] airborne - false if failsafe started on ground with idle throttle,
+ *                        landing is skipped and throttle stays 0
+ */
+void AutoLandStart(float altitude, float hoverEstimate, bool airborne);
+
+/**@brief runs landing state machine
+ *
+ * @param [in] input
+ * @param [in] dt - [s] time since last call
+ * @return throttle 0..1
+ */
+float AutoLandUpdate(const autoLandInput_t* input, float dt);
+
+/**@brief getter for landing phase
+ *
+ * @return current phase
+ */
+autoLandPhase_t AutoLandGetPhase();
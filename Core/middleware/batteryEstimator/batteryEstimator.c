@@ -0,0 +1,200 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/batteryEstimator/batteryEstimator.c
+ *
+ * @brief Source code
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/batteryEstimator/batteryEstimator.h"
+
+#include <stddef.h>
+#include <math.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define OCV_POINTS (11U)    ///< open circuit voltage every 10% of state of charge
+
+#define RESISTANCE_INITIAL (0.015f)     ///< [Ohm] per cell
+#define RESISTANCE_MIN (0.002f)         ///< [Ohm] per cell
+#define RESISTANCE_MAX (0.1f)           ///< [Ohm] per cell
+#define RESISTANCE_GAIN (0.05f)         ///< part of measured resistance error taken per load step
+#define RESISTANCE_MIN_CURRENT_STEP (2.0f)  ///< [A] load change needed to measure resistance
+
+#define FAST_TIME_CONSTANT (0.05f)      ///< [s] removes ADC noise, keeps load steps
+#define SLOW_TIME_CONSTANT (1.0f)       ///< [s] reference for load steps
+#define VOLTAGE_TIME_CONSTANT_CURRENT (60.0f)   ///< [s] voltage correction of coulomb counting
+#define VOLTAGE_TIME_CONSTANT_NO_CURRENT (5.0f) ///< [s] voltage only estimate
+#define RATE_TIME_CONSTANT (10.0f)      ///< [s] discharge rate used for flight time
+#define MIN_DISCHARGE_RATE (0.00001f)   ///< [1/s] slower discharge gives unknown flight time
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+/** LiPo cell open circuit voltage at 0%, 10% ... 100% state of charge **/
+static const float ocvTable[OCV_POINTS] = {3.27f, 3.69f, 3.73f, 3.77f, 3.80f, 3.84f, 3.87f, 3.95f, 4.02f, 4.11f, 4.20f};
+
+static uint8_t cells = 0;
+static float capacityAh = 0;
+static bool currentMeasured = false;
+
+static float stateOfCharge = 0;
+static float resistance = 0;            ///< [Ohm] whole pack
+static float openCircuitVoltage = 0;    ///< [V]
+static float dischargeRate = 0;         ///< [1/s] filtered state of charge decrease
+
+static float fastVoltage = 0;
+static float slowVoltage = 0;
+static float fastCurrent = 0;
+static float slowCurrent = 0;
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief interpolates state of charge from cell open circuit voltage
+ *
+ * @param [in] cellVoltage - [V]
+ * @return state of charge, range 0:1
+ */
+static float SocFromVoltage(float cellVoltage);
+
+/**@brief first order low pass filter step
+ *
+ * @param [in] filtered - previous output
+ * @param [in] input
+ * @param [in] dt - [s]
+ * @param [in] timeConstant - [s]
+ * @return new output
+ */
+static inline float LowPass(float filtered, float input, float dt, float timeConstant);
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+bool BatteryEstimatorInit(uint8_t cellCount, float capacity, float voltage, bool useCurrent)
+{
+    if(cellCount == 0 || capacity <= 0)
+    {
+        return false;
+    }
+
+    cells = cellCount;
+    capacityAh = capacity;
+    currentMeasured = useCurrent;
+
+    resistance = RESISTANCE_INITIAL*(float)cells;
+    openCircuitVoltage = voltage;
+    stateOfCharge = SocFromVoltage(voltage/(float)cells);
+    dischargeRate = 0;
+
+    fastVoltage = voltage;
+    slowVoltage = voltage;
+    fastCurrent = 0;
+    slowCurrent = 0;
+
+    return true;
+}
+
+void BatteryEstimatorUpdate(float voltage, float current, float dt)
+{
+    if(cells == 0 || dt <= 0)
+    {
+        return;
+    }
+
+    if(!currentMeasured)
+    {
+        current = 0;
+    }
+
+    fastVoltage = LowPass(fastVoltage, voltage, dt, FAST_TIME_CONSTANT);
+    slowVoltage = LowPass(slowVoltage, voltage, dt, SLOW_TIME_CONSTANT);
+    fastCurrent = LowPass(fastCurrent, current, dt, FAST_TIME_CONSTANT);
+    slowCurrent = LowPass(slowCurrent, current, dt, SLOW_TIME_CONSTANT);
+
+    /** open circuit voltage barely moves within a second, voltage step follows load step by R **/
+    float currentStep = fastCurrent-slowCurrent;
+    if(fabsf(currentStep) > RESISTANCE_MIN_CURRENT_STEP)
+    {
+        float measuredResistance = (slowVoltage-fastVoltage)/currentStep;
+        float minResistance = RESISTANCE_MIN*(float)cells;
+        float maxResistance = RESISTANCE_MAX*(float)cells;
+
+        if(measuredResistance > minResistance && measuredResistance < maxResistance)
+        {
+            resistance += (measuredResistance-resistance)*RESISTANCE_GAIN*dt/FAST_TIME_CONSTANT;
+        }
+    }
+
+    openCircuitVoltage = fastVoltage+fastCurrent*resistance;
+
+    float previousSoc = stateOfCharge;
+
+    /** coulomb counting, corrected slowly toward sag compensated voltage estimate **/
+    stateOfCharge -= current*dt/(capacityAh*3600.0f);
+    stateOfCharge = LowPass(stateOfCharge,
+                            SocFromVoltage(openCircuitVoltage/(float)cells),
+                            dt,
+                            currentMeasured ? VOLTAGE_TIME_CONSTANT_CURRENT : VOLTAGE_TIME_CONSTANT_NO_CURRENT);
+
+    if(stateOfCharge > 1){stateOfCharge = 1;}
+    if(stateOfCharge < 0){stateOfCharge = 0;}
+
+    dischargeRate = LowPass(dischargeRate, (previousSoc-stateOfCharge)/dt, dt, RATE_TIME_CONSTANT);
+}
+
+bool BatteryEstimatorGetEstimate(batteryEstimate_t* estimate)
+{
+    if(estimate == NULL || cells == 0)
+    {
+        return false;
+    }
+
+    float usable = stateOfCharge-BATTERY_ESTIMATOR_RESERVE;
+    if(usable < 0)
+    {
+        usable = 0;
+    }
+
+    estimate->stateOfCharge = stateOfCharge;
+    estimate->remainingCapacity = usable*capacityAh;
+    estimate->flightTime = dischargeRate > MIN_DISCHARGE_RATE ? usable/dischargeRate : -1;
+    estimate->openCircuitVoltage = openCircuitVoltage;
+    estimate->internalResistance = resistance;
+
+    return true;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static float SocFromVoltage(float cellVoltage)
+{
+    if(cellVoltage <= ocvTable[0])
+    {
+        return 0;
+    }
+
+    for(uint8_t point=1; point<OCV_POINTS; point++)
+    {
+        if(cellVoltage < ocvTable[point])
+        {
+            float part = (cellVoltage-ocvTable[point-1])/(ocvTable[point]-ocvTable[point-1]);
+            return (((float)(point-1))+part)/((float)(OCV_POINTS-1));
+        }
+    }
+
+    return 1;
+}
+
+static inline float LowPass(float filtered, float input, float dt, float timeConstant)
+{
+    return filtered+(input-filtered)*dt/(timeConstant+dt);
+}
@@ -0,0 +1,57 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/batteryEstimator/batteryEstimator.h
+ *
+ * @brief Header file
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define BATTERY_ESTIMATOR_RESERVE (0.2f)    ///< state of charge not counted in flight time
+
+/**@brief battery state estimate **/
+typedef struct{
+    float stateOfCharge;        ///< range 0:1
+    float remainingCapacity;    ///< [Ah] above BATTERY_ESTIMATOR_RESERVE
+    float flightTime;           ///< [s] until BATTERY_ESTIMATOR_RESERVE at current discharge rate, -1 if unknown
+    float openCircuitVoltage;   ///< [V] battery voltage compensated for sag
+    float internalResistance;   ///< [Ohm] whole pack
+}batteryEstimate_t;
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief resets estimator, initial state of charge is taken from rested battery voltage
+ *
+ * @param [in] cellCount
+ * @param [in] capacity - [Ah] full pack capacity
+ * @param [in] voltage - [V] rested battery voltage
+ * @param [in] useCurrent - true if current is measured, otherwise only voltage is used
+ * @return true if successful
+ */
+bool BatteryEstimatorInit(uint8_t cellCount, float capacity, float voltage, bool useCurrent);
+
+/**@brief integrates current and corrects state of charge with sag compensated voltage,
+ *        internal resistance is learned from fast load changes
+ *
+ * @param [in] voltage - [V] battery voltage
+ * @param [in] current - [A] battery current, positive while discharging
+ * @param [in] dt - [s] time since last update
+ */
+void BatteryEstimatorUpdate(float voltage, float current, float dt);
+
+/**@brief getter for latest estimate
+ *
+ * @param [out] estimate
+ * @return true if successful
+ */
+bool BatteryEstimatorGetEstimate(batteryEstimate_t* estimate);
@@ -7,9 +7,12 @@
  * @date May 1, 2021
  ****************************************************************************/
 
+#include "app/deviceManager/deviceManager.h"
+
 #include "drivers/adc/adc.h"
 
 #include "middleware/batteryStatus/batteryStatus.h"
+#include "middleware/batteryEstimator/batteryEstimator.h"
 #include "middleware/soundNotifications/soundNotifications.h"
 
 #include "cmsis_os.h"
@@ -35,7 +38,9 @@
 #define MAX_CELL_COUNT (5U)
 #define BATTERY_MEAS_CELL_COUNT_RETRIES (5U)
 
-#define MEASUREMENTS_COUNT (10U)
+#define BATTERY_STATUS_PERIOD_MS (20U)          ///< [ms] estimator update period
+#define BATTERY_STATUS_CHECK_PERIOD_MS (1000U)  ///< [ms] status check and notification period
+#define BATTERY_STATUS_AVERAGE_PERIOD_MS (10000U)   ///< [ms] without current sensor status is checked with voltage averaged over this time
 
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
@@ -65,6 +70,12 @@ static uint8_t DetectCellCount();
  */
 static batteryStatus_t GetMomentaryBatteryStatus(float voltage, bool* hysteresisRange);
 
+/**@brief sets battery status and notifies device manager if it has changed
+ *
+ * @param [in] status - new battery status
+ */
+static void SetBatteryStatus(batteryStatus_t status);
+
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
 *****************************************************************************/
@@ -74,6 +85,25 @@ batteryStatus_t BatteryStatusGetStatus()
     return batteryStatus;
 }
 
+bool BatteryStatusGetEstimate(batteryEstimate_t* estimate)
+{
+    if(detectedCellCount == 0)
+    {
+        return false;
+    }
+
+    vTaskSuspendAll();
+    bool result = BatteryEstimatorGetEstimate(estimate);
+    xTaskResumeAll();
+
+    return result;
+}
+
+uint8_t BatteryStatusGetCellCount()
+{
+    return detectedCellCount;
+}
+
 void BatteryStatusTask()
 {
     for(uint8_t tries=0; detectedCellCount==0 && tries<BATTERY_MEAS_CELL_COUNT_RETRIES ; tries++)
@@ -83,18 +113,44 @@ void BatteryStatusTask()
 
     while(detectedCellCount == 0)
     {
-        batteryStatus = BATTERY_ERROR;
+        SetBatteryStatus(BATTERY_ERROR);
         SoundNotificationsPlay(SN_BATTERY_ERROR);
         osDelay(1000);
     }
 
     bool hr = 0;
-    batteryStatus = GetMomentaryBatteryStatus(AdcGetBatteryVoltage(),&hr);
+    float voltage = AdcGetBatteryVoltage();
+    SetBatteryStatus(GetMomentaryBatteryStatus(voltage,&hr));
+
+    vTaskSuspendAll();
+    BatteryEstimatorInit(detectedCellCount, BATTERY_CAPACITY_AH, voltage, ADC_CURRENT_SENSOR_SCALE > 0);
+    xTaskResumeAll();
 
-    uint8_t measurementCntr = 0;
-    float measurementSum = 0;
+    TickType_t lastTickTime = xTaskGetTickCount();
+    uint32_t checkCntr = 0;
+    uint32_t averageCntr = 0;
+    float voltageSum = 0;
     while(1)
     {
+        vTaskDelayUntil(&lastTickTime, pdMS_TO_TICKS(BATTERY_STATUS_PERIOD_MS));
+
+        adcData_t adcData;
+        AdcGetData(&adcData);
+
+        vTaskSuspendAll();
+        BatteryEstimatorUpdate(adcData.batteryVoltage, adcData.current, ((float)BATTERY_STATUS_PERIOD_MS)/1000.0f);
+        xTaskResumeAll();
+
+        voltageSum += adcData.batteryVoltage;
+        averageCntr++;
+
+        checkCntr++;
+        if(checkCntr < BATTERY_STATUS_CHECK_PERIOD_MS/BATTERY_STATUS_PERIOD_MS)
+        {
+            continue;
+        }
+        checkCntr = 0;
+
         if(batteryStatus == BATTERY_LOW)
         {
             SoundNotificationsPlay(SN_BATTERY_LOW);
@@ -103,21 +159,27 @@ void BatteryStatusTask()
             SoundNotificationsPlay(SN_BATTERY_ERROR);
         }
 
-        osDelay(1000);
-
-        measurementSum += AdcGetBatteryVoltage();
-
-        measurementCntr++;
-        if(measurementCntr < MEASUREMENTS_COUNT)
+        /** with current sensor thresholds are compared with sag compensated voltage,
+         *  without it estimator voltage is only filtered, so long average rejects throttle punches **/
+        float voltage;
+        if(ADC_CURRENT_SENSOR_SCALE > 0)
         {
-            continue;
+            batteryEstimate_t estimate;
+            BatteryStatusGetEstimate(&estimate);
+            voltage = estimate.openCircuitVoltage;
+        } else
+        {
+            if(averageCntr < BATTERY_STATUS_AVERAGE_PERIOD_MS/BATTERY_STATUS_PERIOD_MS)
+            {
+                continue;
+            }
+            voltage = voltageSum/(float)averageCntr;
         }
+        voltageSum = 0;
+        averageCntr = 0;
 
         bool hysteresisRegion = false;
-        batteryStatus_t tempBatteryStatus = GetMomentaryBatteryStatus(measurementSum/(float)MEASUREMENTS_COUNT,&hysteresisRegion);
-
-        measurementSum = 0;
-        measurementCntr = 0;
+        batteryStatus_t tempBatteryStatus = GetMomentaryBatteryStatus(voltage,&hysteresisRegion);
 
         if(batteryStatus == tempBatteryStatus)
         {
@@ -126,7 +188,7 @@ void BatteryStatusTask()
 
         if(abs(((int8_t)batteryStatus)-((int8_t)tempBatteryStatus)) > 1)
         {
-            batteryStatus = tempBatteryStatus;
+            SetBatteryStatus(tempBatteryStatus);
             continue;
         }
 
@@ -135,7 +197,7 @@ void BatteryStatusTask()
             continue;
         }
 
-        batteryStatus = tempBatteryStatus;
+        SetBatteryStatus(tempBatteryStatus);
     }
 }
 /******************************************************************************
@@ -224,3 +286,14 @@ static batteryStatus_t GetMomentaryBatteryStatus(float voltage, bool* hysteresis
     *hysteresisRange = false;
     return BATTERY_OVERVOLTAGE;
 }
+
+static void SetBatteryStatus(batteryStatus_t status)
+{
+    if(status == batteryStatus)
+    {
+        return;
+    }
+
+    batteryStatus = status;
+    DeviceManagerPostEvent(DM_EVENT_BATTERY_CHANGED);
+}
@@ -11,10 +11,16 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "middleware/batteryEstimator/batteryEstimator.h"
+
 /*****************************************************************************
                        PUBLIC DEFINES / MACROS / ENUMS
 *****************************************************************************/
 
+#ifndef BATTERY_CAPACITY_AH
+#define BATTERY_CAPACITY_AH (1.5f)  ///< [Ah] full pack capacity
+#endif
+
 typedef enum {
     BATTERY_OVERVOLTAGE,
     BATTERY_OK,
@@ -34,7 +40,21 @@ typedef enum {
  */
 batteryStatus_t BatteryStatusGetStatus();
 
+/**@brief getter for battery cell count
+ *
+ * @return detected cell count, 0 if not detected yet or battery voltage is incorrect
+ */
+uint8_t BatteryStatusGetCellCount();
+
+/**@brief getter for battery state of charge, remaining capacity and flight time estimate
+ *
+ * @param [out] estimate
+ * @return true if successful, false if battery was not detected yet
+ */
+bool BatteryStatusGetEstimate(batteryEstimate_t* estimate);
+
 /**@brief battery status freertos task
- *        is called every 1000ms
+ *        updates state of charge estimator every BATTERY_STATUS_PERIOD_MS from ADC snapshot,
+ *        status is checked against sag compensated voltage every 1000ms
  */
 void BatteryStatusTask();
@@ -0,0 +1,371 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/configProtocol/configProtocol.c
+ *
+ * @brief Source code
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/configProtocol/configProtocol.h"
+
+#include "app/deviceManager/deviceManager.h"
+
+#include "middleware/parameters/parameters.h"
+#include "middleware/remoteSettings/remoteSettings.h"
+#include "middleware/memory/memory.h"
+
+#include "drivers/uart/uart.h"
+
+#include "cmsis_os.h"
+#include <string.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define FRAME_TIMEOUT_MS (100U)     ///< [ms] incomplete frame is dropped after this time without new bytes
+#define READ_CHUNK_SIZE (32U)       ///< [bytes]
+
+#define CRC8_POLYNOMIAL (0xD5U)     ///< DVB-S2, same as CRSF
+
+#define FRAME_OVERHEAD (4U)         ///< sync, command, length, crc
+#define VALUE_SIZE (4U)             ///< [bytes] float
+#define SET_ITEM_SIZE (1U+VALUE_SIZE)
+#define MAX_RESPONSE_VALUES ((CONFIG_PROTOCOL_MAX_PAYLOAD-1U)/VALUE_SIZE)
+
+_Static_assert(PARAMETERS_COUNT <= UINT8_MAX, "parameter id is sent as single byte");
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+typedef enum{
+    PARSER_SYNC,
+    PARSER_COMMAND,
+    PARSER_LENGTH,
+    PARSER_PAYLOAD,
+    PARSER_CRC
+}parserState_t;
+
+static struct{
+    parserState_t state;
+    uint8_t command;
+    uint8_t length;
+    uint8_t received;
+    uint8_t payload[CONFIG_PROTOCOL_MAX_PAYLOAD];
+}request;
+
+static uint8_t responseFrame[CONFIG_PROTOCOL_MAX_PAYLOAD+FRAME_OVERHEAD];
+
+static TaskHandle_t configTaskHandle = NULL;
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief wakes up protocol task, called from uart interrupt on idle line
+ */
+static void RxIdleIsr();
+
+/**@brief feeds request parser with one byte
+ *
+ * @param [in] byte
+ * @return true if complete request with valid crc was received
+ */
+static bool ParseByte(uint8_t byte);
+
+/**@brief executes request and sends response
+ */
+static void HandleRequest();
+
+/**@brief builds and sends response frame
+ *
+ * @param [in] status
+ * @param [in] data - response data after status byte
+ * @param [in] size - up to CONFIG_PROTOCOL_MAX_PAYLOAD-1
+ */
+static void SendResponse(configProtocolStatus_t status, const uint8_t* data, uint8_t size);
+
+/**@brief save and change of parameters that are not PARAMETER_LIVE are not allowed while motors can spin
+ *
+ * @return true if all parameters can be changed
+ */
+static bool ChangesAllowed();
+
+/**@brief continues crc8 calculation
+ *
+ * @param [in] crc
+ * @param [in] byte
+ * @return crc
+ */
+static uint8_t Crc8(uint8_t crc, uint8_t byte);
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+void ConfigProtocolTask()
+{
+    configTaskHandle = xTaskGetCurrentTaskHandle();
+    request.state = PARSER_SYNC;
+
+    if(!UartStartReceive(&RxIdleIsr))
+    {
+        vTaskSuspend(NULL);
+    }
+
+    while(1)
+    {
+        bool woken = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FRAME_TIMEOUT_MS)) > 0;
+
+        uint8_t chunk[READ_CHUNK_SIZE];
+        uint32_t count;
+        while((count = UartRead(chunk, sizeof(chunk))) > 0)
+        {
+            woken = true;
+            for(uint32_t i=0; i<count; i++)
+            {
+                if(ParseByte(chunk[i]))
+                {
+                    HandleRequest();
+                }
+            }
+        }
+
+        if(!woken)
+        {
+            request.state = PARSER_SYNC;
+        }
+    }
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static void RxIdleIsr()
+{
+    if(configTaskHandle == NULL)
+    {
+        return;
+    }
+
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(configTaskHandle, &higherPriorityTaskWoken);
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
+
+static bool ParseByte(uint8_t byte)
+{
+    switch(request.state)
+    {
+    case PARSER_SYNC:
+        request.state = byte == CONFIG_PROTOCOL_SYNC ? PARSER_COMMAND : PARSER_SYNC;
+        break;
+    case PARSER_COMMAND:
+        request.command = byte;
+        request.state = PARSER_LENGTH;
+        break;
+    case PARSER_LENGTH:
+        request.length = byte;
+        request.received = 0;
+        if(byte > CONFIG_PROTOCOL_MAX_PAYLOAD)
+        {
+            request.state = PARSER_SYNC;
+        } else
+        {
+            request.state = byte == 0 ? PARSER_CRC : PARSER_PAYLOAD;
+        }
+        break;
+    case PARSER_PAYLOAD:
+        request.payload[request.received] = byte;
+        request.received++;
+        request.state = request.received == request.length ? PARSER_CRC : PARSER_PAYLOAD;
+        break;
+    case PARSER_CRC:
+    {
+        request.state = PARSER_SYNC;
+
+        uint8_t crc = Crc8(Crc8(0, request.command), request.length);
+        for(uint8_t i=0; i<request.length; i++)
+        {
+            crc = Crc8(crc, request.payload[i]);
+        }
+
+        return crc == byte;
+    }
+    default:
+        request.state = PARSER_SYNC;
+        break;
+    }
+
+    return false;
+}
+
+static void HandleRequest()
+{
+    uint8_t data[CONFIG_PROTOCOL_MAX_PAYLOAD-1U];
+    uint8_t size = 0;
+
+    switch(request.command)
+    {
+    case CONFIG_PROTOCOL_INFO:
+    {
+        uint32_t schema = ParametersGetSchemaHash();
+        data[0] = CONFIG_PROTOCOL_VERSION;
+        data[1] = PARAMETERS_COUNT;
+        memcpy(&data[2], &schema, sizeof(schema));
+        SendResponse(CONFIG_PROTOCOL_OK, data, 2+sizeof(schema));
+        return;
+    }
+    case CONFIG_PROTOCOL_DESCRIBE:
+    {
+        if(request.length != 1)
+        {
+            SendResponse(CONFIG_PROTOCOL_INVALID_LENGTH, NULL, 0);
+            return;
+        }
+
+        const parameterDescriptor_t* descriptor = ParametersGetDescriptor(request.payload[0]);
+        if(descriptor == NULL)
+        {
+            SendResponse(CONFIG_PROTOCOL_INVALID_ID, NULL, 0);
+            return;
+        }
+
+        data[size++] = request.payload[0];
+        data[size++] = descriptor->type;
+        data[size++] = descriptor->key;
+        data[size++] = descriptor->flags;
+        memcpy(&data[size], &descriptor->defaultValue, VALUE_SIZE); size += VALUE_SIZE;
+        memcpy(&data[size], &descriptor->min, VALUE_SIZE);          size += VALUE_SIZE;
+        memcpy(&data[size], &descriptor->max, VALUE_SIZE);          size += VALUE_SIZE;
+        memcpy(&data[size], &descriptor->scale, VALUE_SIZE);        size += VALUE_SIZE;
+
+        uint32_t nameLength = strlen(descriptor->name);
+        nameLength = nameLength > sizeof(data)-size ? sizeof(data)-size : nameLength;
+        memcpy(&data[size], descriptor->name, nameLength);
+        SendResponse(CONFIG_PROTOCOL_OK, data, size+nameLength);
+        return;
+    }
+    case CONFIG_PROTOCOL_GET:
+    {
+        if(request.length == 0 || request.length > MAX_RESPONSE_VALUES)
+        {
+            SendResponse(CONFIG_PROTOCOL_INVALID_LENGTH, NULL, 0);
+            return;
+        }
+
+        for(uint8_t i=0; i<request.length; i++)
+        {
+            float value;
+            if(!ParametersGet(request.payload[i], &value))
+            {
+                SendResponse(CONFIG_PROTOCOL_INVALID_ID, NULL, 0);
+                return;
+            }
+            memcpy(&data[size], &value, VALUE_SIZE);
+            size += VALUE_SIZE;
+        }
+
+        SendResponse(CONFIG_PROTOCOL_OK, data, size);
+        return;
+    }
+    case CONFIG_PROTOCOL_SET:
+    {
+        if(request.length == 0 || request.length%SET_ITEM_SIZE != 0)
+        {
+            SendResponse(CONFIG_PROTOCOL_INVALID_LENGTH, NULL, 0);
+            return;
+        }
+
+        /** whole request is rejected if any id is invalid or cannot be changed in flight **/
+        for(uint8_t i=0; i<request.length; i+=SET_ITEM_SIZE)
+        {
+            const parameterDescriptor_t* descriptor = ParametersGetDescriptor(request.payload[i]);
+            if(descriptor == NULL)
+            {
+                SendResponse(CONFIG_PROTOCOL_INVALID_ID, NULL, 0);
+                return;
+            }
+
+            if((descriptor->flags&PARAMETER_LIVE) == 0 && !ChangesAllowed())
+            {
+                SendResponse(CONFIG_PROTOCOL_BUSY, NULL, 0);
+                return;
+            }
+        }
+
+        for(uint8_t i=0; i<request.length; i+=SET_ITEM_SIZE)
+        {
+            float value;
+            memcpy(&value, &request.payload[i+1], VALUE_SIZE);
+            ParametersSet(request.payload[i], value);
+            ParametersGet(request.payload[i], &value);
+            memcpy(&data[size], &value, VALUE_SIZE);
+            size += VALUE_SIZE;
+        }
+
+        RemoteSettingsNotifyUpdate();
+        SendResponse(CONFIG_PROTOCOL_OK, data, size);
+        return;
+    }
+    case CONFIG_PROTOCOL_SAVE:
+    {
+        if(!ChangesAllowed())
+        {
+            SendResponse(CONFIG_PROTOCOL_BUSY, NULL, 0);
+            return;
+        }
+
+        SendResponse(MemorySaveRegisteredVariables() ? CONFIG_PROTOCOL_OK : CONFIG_PROTOCOL_SAVE_FAILED, NULL, 0);
+        return;
+    }
+    default:
+        SendResponse(CONFIG_PROTOCOL_UNKNOWN_COMMAND, NULL, 0);
+        return;
+    }
+}
+
+static void SendResponse(configProtocolStatus_t status, const uint8_t* data, uint8_t size)
+{
+    uint8_t length = size+1U;
+    uint8_t command = request.command|CONFIG_PROTOCOL_RESPONSE;
+
+    responseFrame[0] = CONFIG_PROTOCOL_SYNC;
+    responseFrame[1] = command;
+    responseFrame[2] = length;
+    responseFrame[3] = status;
+    if(size > 0)
+    {
+        memcpy(&responseFrame[4], data, size);
+    }
+
+    uint8_t crc = Crc8(Crc8(0, command), length);
+    for(uint8_t i=0; i<length; i++)
+    {
+        crc = Crc8(crc, responseFrame[3+i]);
+    }
+    responseFrame[3+length] = crc;
+
+    UartWriteBytes(responseFrame, length+FRAME_OVERHEAD);
+}
+
+static bool ChangesAllowed()
+{
+    deviceOperatingModes_t mode = DeviceManagerGetOperatingMode();
+
+    return mode != DEVICE_FLIGHT && mode != DEVICE_HOMING;
+}
+
+static uint8_t Crc8(uint8_t crc, uint8_t byte)
+{
+    crc ^= byte;
+    for(uint8_t bit=0; bit<8; bit++)
+    {
+        crc = (crc&0x80U) != 0 ? (uint8_t)((crc<<1)^CRC8_POLYNOMIAL) : (uint8_t)(crc<<1);
+    }
+
+    return crc;
+}
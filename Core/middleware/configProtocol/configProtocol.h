@@ -0,0 +1,49 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/configProtocol/configProtocol.h
+ *
+ * @brief Binary request/response protocol for reading and writing parameters over debug uart
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+/** frame: CONFIG_PROTOCOL_SYNC, command, payload length, payload, crc8 (poly 0xD5) of command, length and payload
+ *  response has command | CONFIG_PROTOCOL_RESPONSE and first payload byte is configProtocolStatus_t,
+ *  multi byte values are little endian, values are transferred as float **/
+#define CONFIG_PROTOCOL_SYNC (0xC5U)
+#define CONFIG_PROTOCOL_RESPONSE (0x80U)
+#define CONFIG_PROTOCOL_MAX_PAYLOAD (240U)  ///< [bytes]
+#define CONFIG_PROTOCOL_VERSION (2U)
+
+typedef enum{
+    CONFIG_PROTOCOL_INFO = 0x01,        ///< req: -, resp: version u8, parameter count u8, schema hash u32
+    CONFIG_PROTOCOL_DESCRIBE = 0x02,    ///< req: id u8, resp: id u8, type u8, key u8, flags u8, default, min, max, scale, name
+    CONFIG_PROTOCOL_GET = 0x03,         ///< req: id u8 * n, resp: value * n
+    CONFIG_PROTOCOL_SET = 0x04,         ///< req: (id u8, value) * n, resp: value after clamping * n, only PARAMETER_LIVE in flight
+    CONFIG_PROTOCOL_SAVE = 0x05         ///< req: -, resp: -
+}configProtocolCommand_t;
+
+typedef enum{
+    CONFIG_PROTOCOL_OK = 0,
+    CONFIG_PROTOCOL_UNKNOWN_COMMAND,
+    CONFIG_PROTOCOL_INVALID_LENGTH,
+    CONFIG_PROTOCOL_INVALID_ID,
+    CONFIG_PROTOCOL_BUSY,               ///< save and set of not live parameters are refused in flight
+    CONFIG_PROTOCOL_SAVE_FAILED
+}configProtocolStatus_t;
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief freertos task, starts uart reception and serves requests
+ */
+void ConfigProtocolTask();
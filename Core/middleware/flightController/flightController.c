@@ -10,6 +10,7 @@
 #include "drivers/uart/uart.h"
 #include "drivers/eeprom/eeprom.h"
 #include "drivers/motors/motors.h"
+#include "drivers/adc/adc.h"
 
 #include "middleware/flightController/flightController.h"
 #include "middleware/quaternion/quaternion.h"
@@ -18,10 +19,16 @@
 #include "middleware/vector/vector.h"
 #include "middleware/quaternion/quaternion.h"
 #include "middleware/pid/pid.h"
+#include "middleware/pid/pidBaseline.h"
 #include "middleware/remoteSettings/remoteSettings.h"
+#include "middleware/parameters/parameters.h"
 #include "middleware/memory/memory.h"
 #include "middleware/radioStatus/radioStatus.h"
-#include "middleware/digitalFilter/digitalFilter.h"
+#include "middleware/mixer/mixer.h"
+#include "middleware/batteryStatus/batteryStatus.h"
+#include "middleware/altitude/altitude.h"
+#include "middleware/altitudeHold/altitudeHold.h"
+#include "middleware/autoLand/autoLand.h"
 
 #include "app/deviceManager/deviceManager.h"
 
@@ -39,22 +46,75 @@
 #define YAW_MIN_INCREMENT_D (2.0f)  ///< deg/s minimal yaw stick value above which yaw is affected
 #define ROLL_PITCH_MIN_VALUE_D (0.2f)   ///< deg bellow this value roll/pitch will be 0
 
-#define MIN_THROTTLE    (0.3f)
-#define MAX_THROTTLE    (0.7f)
-#define MAX_BALANCE_XY  (0.1f)
+#define MAX_THROTTLE    (0.7f)             ///< throttle range, full stick gives this collective thrust
+#define MAX_BALANCE_XY  (0.1f)              ///< PID output limits, mixer handles saturation at both throttle ends
 #define MAX_BALANCE_Z   (0.1f)
 
+#define PID_INTEGRAL_LIMIT_XY (0.5f*MAX_BALANCE_XY) ///< I term may hold at most half of balance authority
+#define PID_INTEGRAL_LIMIT_Z  (0.5f*MAX_BALANCE_Z)
+#define PID_TRACKING_GAIN     (10.0f)               ///< [1/s] anti-windup, I term unwinds in ~0.1s when saturated
+
+#define FLIGHT_CONTROLLER_MIXER MIXER_QUAD_X    ///< mixer outputs are in motors_t order
+#define FLIGHT_CONTROLLER_THRUST_LINEARIZATION (0.0f)   ///< 0 disables, quadratic part of motor thrust curve
+
+#define VOLTAGE_COMPENSATION_ENABLED (1U)           ///< 1 boosts outputs when battery sags
+#define VOLTAGE_COMPENSATION_PERIOD_MS (10U)        ///< [ms] compensation is updated at most this often
+#define VOLTAGE_COMPENSATION_TIME_CONSTANT (0.1f)   ///< [s] battery voltage filter, follows sag, rejects ripple
+#define VOLTAGE_COMPENSATION_CELL_VOLTAGE (4.0f)    ///< [V] loaded full cell, gains are tuned at this voltage
+
+#define YAW_ERROR_STAGE_TIME_CONSTANT (0.1024f)  ///< [s] two stages give 1Hz cut-off, sqrt(sqrt(2)-1)/(2*pi*1Hz)
+
+#define FLIGHT_CONTROLLER_MAX_PERIOD_MS (20U)   ///< [ms] loop runs on every radio frame, but at least this often
+
+#ifndef FLIGHT_CONTROLLER_PID_BENCHMARK
+#define FLIGHT_CONTROLLER_PID_BENCHMARK (0U)    ///< 1 also runs three original heap handle PIDs on the same data to compare cycles
+#endif
+
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
 *****************************************************************************/
 
 static volatile float yaw = 0;
 
-static pidHandle_t pidHandleX = 0;
-static pidHandle_t pidHandleY = 0;
-static pidHandle_t pidHandleZ = 0;
+static pidBank_t pidBank;    ///< x, y, z attitude regulators
+
+/** measurement for PIDs, body rotation integrated from orientation changes,
+ *  continuous unlike orientation angles and independent of target, so stick moves do not kick D term **/
+static quaternion_t lastOrientation = {.w = 1};
+static vector_t measuredRotation = {0};
+
+/** z axis error low pass, two first order stages, coefficients follow sample time of the loop **/
+static float yawErrorStages[2] = {0};
+
+/**@brief double buffered controller gains, settings callbacks fill block not used by control loop,
+ *        control loop swaps blocks at iteration start, gains never change during pid calculation
+ */
+static struct{
+    pidGains_t xy;
+    pidGains_t z;
+}gainBlocks[2];
+static uint32_t activeGainBlock = 0;    ///< block used by control loop
+static bool gainBlockPending = false;   ///< other block holds newer gains
+
+static bool altitudeHoldActive = false;
+static bool autoLandActive = false;
+static bool landedPosted = false;           ///< DM_EVENT_LANDED is posted once per landing
+static float lastThrottle = 0;              ///< throttle of last flight mode iteration, hover estimate for auto land
+
+static float batteryVoltage = 0;            ///< [V] filtered, 0 if not measured since flight start
+static TickType_t batteryVoltageTime = 0;   ///< tick of last battery measurement
+
+/** time from radio frame reception to motors update, DWT cycles **/
+static volatile uint32_t stickLatency = 0;
+static volatile uint32_t stickLatencyMax = 0;
+
+/** max duration of PID calculation since arming, DWT cycles **/
+static volatile uint32_t pidBankCycles = 0;
+static volatile uint32_t pidBaselineCycles = 0;     ///< three PidBaselineCalc calls, FLIGHT_CONTROLLER_PID_BENCHMARK only
 
-static digitalFilterHandle_t filterHandleAz;
+#if FLIGHT_CONTROLLER_PID_BENCHMARK
+static pidBaselineHandle_t benchmarkPid[PID_BANK_AXES];
+#endif
 
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
@@ -63,29 +123,68 @@ static digitalFilterHandle_t filterHandleAz;
 /**@brief calculates target orientation based on data from radio
  *        target orientation is calculated as :
  *        rotation around Z axis -> simultaneous rotation around X and Y axes
+ * @param [in] frame - radio frame
  * @param [in] sampleTime
  * @return target rotation as quaternion
  */
-static quaternion_t CalcTargetOrientation(float sampleTime);
+static quaternion_t CalcTargetOrientation(const radioFrame_t* frame, float sampleTime);
 
-/**@brief sets PID x,y,z parameters to values stored in remote settings
+/**@brief copies PID parameters to inactive gain block and marks it for swap,
+ *        can be called from any task
+ */
+static void PublishGains();
+
+/**@brief swaps in gain block published since last call and loads it into PID x,y,z,
+ *        called by control loop between iterations
  *
  * @return true if successful
  */
-static bool UpdatePidParams();
+static bool ApplyPublishedGains();
 
-/**@brief when any setting in remoteSettings is changed this callback is called to update it locally
+/**@brief when any setting in remoteSettings or over config protocol is changed this callback publishes new gains
  */
 static void SettingsUpdateCallback();
 
-/**@brief mixes output data fromPId regulators and throttle to get values that are send to the motors
+/**@brief mixes output data from PID regulators with throttle and sends it to all motors at once,
+ *        differential commands are dropped at idle, otherwise mixer moves throttle (airmode)
  *
  * @param [in] throttle
+ * @param [in] idle - true if motors have to stay at throttle, only on ground
  * @param [in] x - output value from X axis PID regulator
  * @param [in] y - output value from Y axis PID regulator
  * @param [in] z - output value from Z axis PID regulator
  */
-static void MixSignals(float throttle, float x, float y, float z);
+static void MixSignals(float throttle, bool idle, float x, float y, float z);
+
+/**@brief altitude hold is selected with switch channel, throttle stick commands climb rate
+ *        falls back to manual throttle until baro ground reference is calibrated
+ *
+ * @param [in] frame - radio frame
+ * @param [in] sampleTime
+ * @return throttle 0..1
+ */
+static float CalcThrottle(const radioFrame_t* frame, float sampleTime);
+
+/**@brief runs auto land in homing mode, posts DM_EVENT_LANDED after touchdown
+ *
+ * @param [in] orientationError - from level target, sticks are masked in homing
+ * @param [in] peakAcceleration - [m/s^2] max vertical acceleration since last iteration
+ * @param [in] sampleTime
+ * @return throttle 0..1
+ */
+static float CalcLandingThrottle(vector_t orientationError, float peakAcceleration, float sampleTime);
+
+/**@brief low passes z axis error, loop runs once per radio frame, so coefficients are derived from sample time
+ *
+ * @param [in] error - [rad]
+ * @param [in] sampleTime - [s]
+ * @return filtered error [rad]
+ */
+static float FilterYawError(float error, float sampleTime);
+
+/**@brief measures battery every VOLTAGE_COMPENSATION_PERIOD_MS and updates mixer voltage compensation
+ */
+static void UpdateVoltageCompensation();
 
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
@@ -93,27 +192,35 @@ static void MixSignals(float throttle, float x, float y, float z);
 
 bool FlightControllerInit()
 {
-    if(!PidInit(&pidHandleX,0,0,0,0)) { return false; }
-    if(!PidInit(&pidHandleY,0,0,0,0)) { return false; }
-    if(!PidInit(&pidHandleZ,0,0,0,0)) { return false; }
+    if(!PidBankInit(&pidBank, &gainBlocks[activeGainBlock].xy)) { return false; }
 
-    if(!UpdatePidParams()){return false;}
+#if FLIGHT_CONTROLLER_PID_BENCHMARK
+    for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+    {
+        const pidGains_t* gains = &gainBlocks[activeGainBlock].xy;
+        if(!PidBaselineInit(&benchmarkPid[axis], gains->p, gains->i, gains->d, gains->filterCoefficient)) { return false; }
+    }
+#endif
 
-    if(!RemoteSettingsAddUpdateCallback(&SettingsUpdateCallback)){return false;}
+    PublishGains();
+    if(!ApplyPublishedGains()){return false;}
 
-    /** 1Hz low pass filter for z axis**/
-    float numerator[] = {0.003621681514929, 0.007243363029857, 0.003621681514929};
-    float denominator[] = {1, -1.822694925196308, 0.837181651256023};
+    if(!MixerInit(FLIGHT_CONTROLLER_MIXER)){return false;}
+    if(MixerGetMotorCount() != MOTORS_COUNT){return false;}
+    MixerSetThrustLinearization(FLIGHT_CONTROLLER_THRUST_LINEARIZATION);
 
-    if(!DigitalFilterCreateFilter(numerator, denominator, 2, &filterHandleAz)){return false;}
+    if(!RemoteSettingsAddUpdateCallback(&SettingsUpdateCallback)){return false;}
 
     return true;
 }
 
 void FlightControllerTask()
 {
-    uint32_t previousWakeTime = osKernelSysTick();
     uint32_t lastTimeCalled = 0;
+    uint32_t lastSequence = 0;
+
+    RadioStatusSubscribe(xTaskGetCurrentTaskHandle());
+
     while(1)
     {
         if(DeviceManagerGetOperatingMode() != DEVICE_FLIGHT &&
@@ -121,50 +228,140 @@ void FlightControllerTask()
         {
             vTaskSuspend(NULL);
             GetTimeElapsed(&lastTimeCalled, true);
-            previousWakeTime = osKernelSysTick();
+            stickLatencyMax = 0;
+            pidBankCycles = 0;
+            pidBaselineCycles = 0;
+            batteryVoltage = 0;
+            altitudeHoldActive = false;
+            autoLandActive = false;
+            lastThrottle = 0;
 
             vector_t startingOrientation = QuatTranslateToRotationVector(MahonyFilterGetOrientation());
             yaw = startingOrientation.z;
+
+            lastOrientation = MahonyFilterGetOrientation();
+            measuredRotation = (vector_t){0};
+            yawErrorStages[0] = 0;
+            yawErrorStages[1] = 0;
+            PidBankReset(&pidBank);
         }
 
+        ApplyPublishedGains();
+
         float sampleTime = GetTimeElapsed(&lastTimeCalled, true);
 
-        quaternion_t targetOrientation = CalcTargetOrientation(sampleTime);
+        radioFrame_t frame;
+        RadioStatusGetFrame(&frame);
+
+        quaternion_t targetOrientation = CalcTargetOrientation(&frame, sampleTime);
 
         quaternion_t currentOrientation = MahonyFilterGetOrientation();
 
         vector_t orientationError = QuatTranslateToRotationVector(QuatProd(QuatInv(currentOrientation),targetOrientation));
 
-        DigitalFilterProcess(filterHandleAz, orientationError.z, &(orientationError.z));
+        orientationError.z = FilterYawError(orientationError.z, sampleTime);
+
+        measuredRotation = VectorSum(measuredRotation,
+            QuatTranslateToRotationVector(QuatProd(QuatInv(lastOrientation), currentOrientation)));
+        lastOrientation = currentOrientation;
+
+        /** error = setpoint - measurement stays exactly orientationError **/
+        vector_t setpoint = VectorSum(measuredRotation, orientationError);
 
         float throttle = 0;
+        float peakAcceleration = AltitudeGetPeakAcceleration();
+        /** low throttle is idle only from manual stick or after touchdown,
+         *  altitude hold and auto land stay above it in flight and keep attitude control **/
+        bool onGround = true;
 
         if(DeviceManagerGetOperatingMode() == DEVICE_FLIGHT)
         {
-            throttle = RadioStatusGetChannelData(RADIO_THROTTLE_CHANNEL);
+            throttle = CalcThrottle(&frame, sampleTime);
+            lastThrottle = throttle;
+            autoLandActive = false;
+            onGround = !altitudeHoldActive;
         } else if(DeviceManagerGetOperatingMode() == DEVICE_HOMING)
         {
-            throttle = 0;
+            throttle = CalcLandingThrottle(orientationError, peakAcceleration, sampleTime);
+            altitudeHoldActive = false;
+            onGround = AutoLandGetPhase() >= AUTO_LAND_TOUCHDOWN;
+        }
+        bool idle = onGround && throttle < DEVICE_MANAGER_THROTTLE_OFF_TRH;
+
+        UpdateVoltageCompensation();
+
+        float setpoints[PID_BANK_AXES] = {setpoint.x, setpoint.y, setpoint.z};
+        float measurements[PID_BANK_AXES] = {measuredRotation.x, measuredRotation.y, measuredRotation.z};
+        float outputs[PID_BANK_AXES];
+
+        /** integrators would wind up against the ground at idle **/
+        if(idle)
+        {
+            PidBankReset(&pidBank);
+        }
+
+        uint32_t pidStart = DWT->CYCCNT;
+        PidBankCalc(&pidBank, setpoints, measurements, sampleTime, outputs);
+        uint32_t cycles = DWT->CYCCNT-pidStart;
+        pidBankCycles = cycles > pidBankCycles ? cycles : pidBankCycles;
+
+#if FLIGHT_CONTROLLER_PID_BENCHMARK
+        /** original PIDs were never reset, each call measures its own sample time **/
+        pidStart = DWT->CYCCNT;
+        for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+        {
+            PidBaselineCalc(benchmarkPid[axis], setpoints[axis]-measurements[axis]);
         }
+        cycles = DWT->CYCCNT-pidStart;
+        pidBaselineCycles = cycles > pidBaselineCycles ? cycles : pidBaselineCycles;
+#endif
 
-        MixSignals(throttle,
-            PidCalc(pidHandleX, orientationError.x),
-            PidCalc(pidHandleY, orientationError.y),
-            PidCalc(pidHandleZ, orientationError.z));
+        MixSignals(throttle, idle, outputs[PID_BANK_X], outputs[PID_BANK_Y], outputs[PID_BANK_Z]);
 
-        osDelayUntil(&previousWakeTime,20);
+        if(frame.sequence != lastSequence)
+        {
+            lastSequence = frame.sequence;
+            stickLatency = DWT->CYCCNT-frame.timestamp;
+            if(stickLatency > stickLatencyMax)
+            {
+                stickLatencyMax = stickLatency;
+            }
+        }
+
+        /** wait for next radio frame **/
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FLIGHT_CONTROLLER_MAX_PERIOD_MS));
     }
 }
 
+bool FlightControllerGetStickLatency(float* latency, float* maxLatency)
+{
+    RETURN_IF_TRUE(latency == NULL || maxLatency == NULL, false)
+
+    *latency = ((float)stickLatency)/((float)SystemCoreClock);
+    *maxLatency = ((float)stickLatencyMax)/((float)SystemCoreClock);
+
+    return true;
+}
+
+bool FlightControllerGetPidCycles(uint32_t* bankCycles, uint32_t* baselineCycles)
+{
+    RETURN_IF_TRUE(bankCycles == NULL || baselineCycles == NULL, false)
+
+    *bankCycles = pidBankCycles;
+    *baselineCycles = pidBaselineCycles;
+
+    return true;
+}
+
 /******************************************************************************
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
 
-static quaternion_t CalcTargetOrientation(float sampleTime)
+static quaternion_t CalcTargetOrientation(const radioFrame_t* frame, float sampleTime)
 {
     static bool yawIncremented = false;
 
-    float yawIncrement = -RadioStatusGetChannelData(RADIO_YAW_CHANNEL)*YAW_MAX_ANGLE_DPS*(M_PI)/(180.0f)*sampleTime;
+    float yawIncrement = -frame->channelData[RADIO_YAW_CHANNEL]*YAW_MAX_ANGLE_DPS*(M_PI)/(180.0f)*sampleTime;
 
     if(fabs(yawIncrement) > YAW_MIN_INCREMENT_D*M_PI/180*sampleTime)
     {
@@ -185,8 +382,8 @@ static quaternion_t CalcTargetOrientation(float sampleTime)
     }
 
     vector_t yawRotation = {0, 0, yaw};
-    vector_t rpRotation = {RadioStatusGetChannelData(RADIO_ROLL_CHANNEL)*ROLL_MAX_ANGLE_D*M_PI/180,
-                           RadioStatusGetChannelData(RADIO_PITCH_CHANNEL)*PITCH_MAX_ANGLE_D*M_PI/180,
+    vector_t rpRotation = {frame->channelData[RADIO_ROLL_CHANNEL]*ROLL_MAX_ANGLE_D*M_PI/180,
+                           frame->channelData[RADIO_PITCH_CHANNEL]*PITCH_MAX_ANGLE_D*M_PI/180,
                            0};
 
     if(fabs(rpRotation.x) < ROLL_PITCH_MIN_VALUE_D*M_PI/180)
@@ -202,69 +399,189 @@ static quaternion_t CalcTargetOrientation(float sampleTime)
     return QuatProd(QuatTranslateVectorToQuaternion(yawRotation),QuatTranslateVectorToQuaternion(rpRotation));
 }
 
-static bool UpdatePidParams()
+static void PublishGains()
+{
+    /** swap cannot happen while inactive block is written **/
+    taskENTER_CRITICAL();
+
+    uint32_t block = 1U-activeGainBlock;
+
+    gainBlocks[block].xy.p = PARAMETERS_GET(PID_XY_P);
+    gainBlocks[block].xy.i = PARAMETERS_GET(PID_XY_I);
+    gainBlocks[block].xy.d = PARAMETERS_GET(PID_XY_D);
+    gainBlocks[block].xy.ff = PARAMETERS_GET(PID_XY_FF);
+    gainBlocks[block].xy.filterCoefficient = PARAMETERS_GET(PID_N);
+    gainBlocks[block].xy.integralLimit = PID_INTEGRAL_LIMIT_XY;
+    gainBlocks[block].xy.outputLimit = MAX_BALANCE_XY;
+    gainBlocks[block].xy.trackingGain = PID_TRACKING_GAIN;
+
+    gainBlocks[block].z.p = PARAMETERS_GET(PID_Z_P);
+    gainBlocks[block].z.i = PARAMETERS_GET(PID_Z_I);
+    gainBlocks[block].z.d = PARAMETERS_GET(PID_Z_D);
+    gainBlocks[block].z.ff = PARAMETERS_GET(PID_Z_FF);
+    gainBlocks[block].z.filterCoefficient = PARAMETERS_GET(PID_N);
+    gainBlocks[block].z.integralLimit = PID_INTEGRAL_LIMIT_Z;
+    gainBlocks[block].z.outputLimit = MAX_BALANCE_Z;
+    gainBlocks[block].z.trackingGain = PID_TRACKING_GAIN;
+
+    gainBlockPending = true;
+
+    taskEXIT_CRITICAL();
+}
+
+static bool ApplyPublishedGains()
 {
-    float pxy, ixy, dxy, pz, iz, dz, n;
-
-    if(!RemoteSettingsGetVariable(RS_PID_XY_P, &pxy)){return false;}
-    if(!RemoteSettingsGetVariable(RS_PID_XY_I, &ixy)){return false;}
-    if(!RemoteSettingsGetVariable(RS_PID_XY_D, &dxy)){return false;}
-    if(!RemoteSettingsGetVariable(RS_PID_Z_P , &pz )){return false;}
-    if(!RemoteSettingsGetVariable(RS_PID_Z_I , &iz )){return false;}
-    if(!RemoteSettingsGetVariable(RS_PID_Z_D , &dz )){return false;}
-    if(!RemoteSettingsGetVariable(RS_PID_N   , &n  )){return false;}
-
-    if(!PidSetParam(pidHandleX, PID_P, pxy)){return false;}
-    if(!PidSetParam(pidHandleX, PID_I, ixy)){return false;}
-    if(!PidSetParam(pidHandleX, PID_D, dxy)){return false;}
-    if(!PidSetParam(pidHandleX, PID_N, n  )){return false;}
-
-    if(!PidSetParam(pidHandleY, PID_P, pxy)){return false;}
-    if(!PidSetParam(pidHandleY, PID_I, ixy)){return false;}
-    if(!PidSetParam(pidHandleY, PID_D, dxy)){return false;}
-    if(!PidSetParam(pidHandleY, PID_N, n  )){return false;}
-
-    if(!PidSetParam(pidHandleZ, PID_P, pz )){return false;}
-    if(!PidSetParam(pidHandleZ, PID_I, iz )){return false;}
-    if(!PidSetParam(pidHandleZ, PID_D, dz )){return false;}
-    if(!PidSetParam(pidHandleZ, PID_N, n  )){return false;}
+    bool swapped = false;
+
+    taskENTER_CRITICAL();
+    if(gainBlockPending)
+    {
+        activeGainBlock = 1U-activeGainBlock;
+        gainBlockPending = false;
+        swapped = true;
+    }
+    taskEXIT_CRITICAL();
+
+    if(!swapped)
+    {
+        return true;
+    }
+
+    const pidGains_t* xy = &gainBlocks[activeGainBlock].xy;
+    const pidGains_t* z = &gainBlocks[activeGainBlock].z;
+
+    if(!PidBankSetGains(&pidBank, PID_BANK_X, xy)){return false;}
+    if(!PidBankSetGains(&pidBank, PID_BANK_Y, xy)){return false;}
+    if(!PidBankSetGains(&pidBank, PID_BANK_Z, z)){return false;}
+
+#if FLIGHT_CONTROLLER_PID_BENCHMARK
+    for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+    {
+        const pidGains_t* gains = axis == PID_BANK_Z ? z : xy;
+        if(!PidBaselineSetParam(benchmarkPid[axis], PID_BASELINE_P, gains->p)){return false;}
+        if(!PidBaselineSetParam(benchmarkPid[axis], PID_BASELINE_I, gains->i)){return false;}
+        if(!PidBaselineSetParam(benchmarkPid[axis], PID_BASELINE_D, gains->d)){return false;}
+        if(!PidBaselineSetParam(benchmarkPid[axis], PID_BASELINE_N, gains->filterCoefficient)){return false;}
+    }
+#endif
 
     return true;
 }
 
 static void SettingsUpdateCallback()
 {
-    UpdatePidParams();
+    PublishGains();
 }
 
-static void MixSignals(float throttle, float x, float y, float z)
+static void MixSignals(float throttle, bool idle, float x, float y, float z)
 {
     if(throttle>1)
     {
         throttle = 1;
     }
 
+    /** idle on ground, airmode would spin motors up with attitude corrections **/
+    if(idle)
+    {
+        x = 0;
+        y = 0;
+        z = 0;
+    }
+
     throttle *= MAX_THROTTLE;
 
-    float balanceCut = throttle<MIN_THROTTLE ? throttle/MIN_THROTTLE : 1;
+    float power[MIXER_MAX_MOTORS];
 
-    if(fabs(x) > MAX_BALANCE_XY*balanceCut)
+    MixerMix(throttle, x, y, z, power);
+    MotorsSetAll(power);
+}
+
+static float CalcThrottle(const radioFrame_t* frame, float sampleTime)
+{
+    float stick = frame->channelData[RADIO_THROTTLE_CHANNEL];
+
+    if(frame->channelData[RADIO_SWITCH_CHANNEL] < DEVICE_MANAGER_SWITCH_OFF_TRH || !AltitudeIsCalibrated())
+    {
+        altitudeHoldActive = false;
+        return stick;
+    }
+
+    float altitude = AltitudeGetAltitudeFromHome();
+    if(!altitudeHoldActive)
+    {
+        AltitudeHoldReset(altitude, stick);
+        altitudeHoldActive = true;
+    }
+
+    return AltitudeHoldUpdate(AltitudeHoldStickToClimbRate(stick), altitude, AltitudeGetClimbRate(), sampleTime);
+}
+
+static float CalcLandingThrottle(vector_t orientationError, float peakAcceleration, float sampleTime)
+{
+    autoLandInput_t input = {.altitude = AltitudeGetAltitudeFromHome(),
+                             .climbRate = AltitudeGetClimbRate(),
+                             .peakAcceleration = peakAcceleration,
+                             .attitudeError = sqrtf(orientationError.x*orientationError.x + orientationError.y*orientationError.y),
+                             .estimateValid = AltitudeIsCalibrated()};
+
+    if(!autoLandActive)
     {
-        x = ((float)((x>0)*2-1))*MAX_BALANCE_XY*balanceCut;
+        /** stick at signal loss says nothing about hover, it may be a punch out or a drop **/
+        float hoverThrottle = AltitudeHoldIsHoverLearned() ? AltitudeHoldGetHoverThrottle() : PARAMETERS_GET(HOVER_THROTTLE);
+        AutoLandStart(input.altitude, hoverThrottle, lastThrottle > DEVICE_MANAGER_THROTTLE_OFF_TRH);
+        autoLandActive = true;
+        landedPosted = false;
     }
 
-    if(fabs(y) > MAX_BALANCE_XY*balanceCut)
+    float throttle = AutoLandUpdate(&input, sampleTime);
+
+    if(AutoLandGetPhase() == AUTO_LAND_LANDED && !landedPosted)
     {
-        y = ((float)((y>0)*2-1))*MAX_BALANCE_XY*balanceCut;
+        DeviceManagerPostEvent(DM_EVENT_LANDED);
+        landedPosted = true;
     }
 
-    if(fabs(z) > MAX_BALANCE_Z*balanceCut)
+    return throttle;
+}
+
+static float FilterYawError(float error, float sampleTime)
+{
+    float alpha = sampleTime/(YAW_ERROR_STAGE_TIME_CONSTANT+sampleTime);
+
+    yawErrorStages[0] += (error-yawErrorStages[0])*alpha;
+    yawErrorStages[1] += (yawErrorStages[0]-yawErrorStages[1])*alpha;
+
+    return yawErrorStages[1];
+}
+
+static void UpdateVoltageCompensation()
+{
+#if VOLTAGE_COMPENSATION_ENABLED
+    TickType_t now = xTaskGetTickCount();
+    TickType_t elapsed = now-batteryVoltageTime;
+    if(batteryVoltage > 0 && elapsed < pdMS_TO_TICKS(VOLTAGE_COMPENSATION_PERIOD_MS))
+    {
+        return;
+    }
+    batteryVoltageTime = now;
+
+    uint8_t cellCount = BatteryStatusGetCellCount();
+    float voltage = AdcGetBatteryVoltage();
+    if(cellCount == 0 || voltage <= 0)
+    {
+        MixerSetVoltageCompensation(1);
+        return;
+    }
+
+    if(batteryVoltage <= 0)
+    {
+        batteryVoltage = voltage;
+    } else
     {
-        z = ((float)((z>0)*2-1))*MAX_BALANCE_Z*balanceCut;
+        float dt = ((float)elapsed)/((float)configTICK_RATE_HZ);
+        batteryVoltage += (voltage-batteryVoltage)*dt/(VOLTAGE_COMPENSATION_TIME_CONSTANT+dt);
     }
 
-    MotorsSet(MOTORS_FRONT_RIGHT,  throttle-x-y+z);
-    MotorsSet(MOTORS_FRONT_LEFT ,  throttle+x-y-z);
-    MotorsSet(MOTORS_BACK_LEFT  ,  throttle+x+y+z);
-    MotorsSet(MOTORS_BACK_RIGHT ,  throttle-x+y-z);
+    MixerSetVoltageCompensation(VOLTAGE_COMPENSATION_CELL_VOLTAGE*((float)cellCount)/batteryVoltage);
+#endif
 }
@@ -28,5 +28,26 @@
 bool FlightControllerInit();
 
 /**@brief freertos task
+ *        runs control loop on every new radio frame, or every 20ms if no frame arrives
  */
 void FlightControllerTask();
+
+/**@brief getter for stick to motor latency measured with DWT,
+ *        time from receiving radio frame to updating motors with it,
+ *        reported on debug uart at disarm
+ *
+ * @param [out] latency - last measured latency [s]
+ * @param [out] maxLatency - max latency since arming [s]
+ * @return true if successful
+ */
+bool FlightControllerGetStickLatency(float* latency, float* maxLatency);
+
+/**@brief getter for max duration of attitude PID calculation since arming measured with DWT,
+ *        reported on debug uart at disarm
+ *
+ * @param [out] bankCycles - PidBankCalc of x, y, z [cycles]
+ * @param [out] baselineCycles - three original heap handle PIDs on the same data [cycles],
+ *                               0 unless built with -DFLIGHT_CONTROLLER_PID_BENCHMARK=1
+ * @return true if successful
+ */
+bool FlightControllerGetPidCycles(uint32_t* bankCycles, uint32_t* baselineCycles);
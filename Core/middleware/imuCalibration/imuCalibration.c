@@ -11,7 +11,7 @@
 
 #include "middleware/soundNotifications/soundNotifications.h"
 #include "middleware/radioStatus/radioStatus.h"
-#include "middleware/remoteSettings/remoteSettings.h"
+#include "middleware/parameters/parameters.h"
 #include "middleware/vector/vector.h"
 #include "middleware/mahonyFilter/mahonyFilter.h"
 
@@ -104,9 +104,18 @@ static float MatlabMod(float x, float y);
 
 void ImuCalibrationTask()
 {
+    bool calibrationStarted = false;
+
     while(1)
     {
+        /** calibration finished or was aborted **/
+        if(calibrationStarted)
+        {
+            DeviceManagerPostEvent(DM_EVENT_CALIBRATION_DONE);
+        }
+
         vTaskSuspend(NULL);
+        calibrationStarted = true;
 
         SoundNotificationsPlay(SN_CALIBRATION_START);
         osDelay(500);
@@ -144,9 +153,7 @@ void ImuCalibrationTask()
         Bmx055SetAccOffsets(accSum.x,accSum.y,accSum.z-ACC_Z_TARGET_VALUE);
         Bmx055SetGyroOffsets(gyroSum.x,gyroSum.y,gyroSum.z);
 
-        float calibration = 0;
-        RemoteSettingsGetVariable(RS_CALIBRATION, &calibration);
-        if(calibration < 0)
+        if(PARAMETERS_GET(CALIBRATION) < 0)
         {
             while(true != SoundNotificationsPlay(SN_CALIBRATION_FINISHED)){}
             continue;
@@ -8,7 +8,10 @@
  ****************************************************************************/
 
 #include "middleware/mahonyFilter/mahonyFilter.h"
+#include "middleware/altitude/altitude.h"
 #include "middleware/digitalFilter/digitalFilter.h"
+#include "middleware/motorTelemetry/motorTelemetry.h"
+#include "middleware/rpmFilter/rpmFilter.h"
 
 #include "drivers/BMX055/BMX055.h"
 #include "drivers/uart/uart.h"
@@ -32,6 +35,8 @@
 
 #define EARTH_GRAVITY_ACC (9.81f)
 
+#define MAHONY_FILTER_FREQUENCY ((float)configTICK_RATE_HZ) ///< [Hz] task runs every tick
+
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
 *****************************************************************************/
@@ -66,6 +71,7 @@ bool MahonyFilterInit()
     if(!DigitalFilterCreateFilter(numerator, denominator, 2, &filterHandleAx)){return false;}
     if(!DigitalFilterCreateFilter(numerator, denominator, 2, &filterHandleAy)){return false;}
     if(!DigitalFilterCreateFilter(numerator, denominator, 2, &filterHandleAz)){return false;}
+    if(!RpmFilterInit(MAHONY_FILTER_FREQUENCY)){return false;}
     return true;
 }
 
@@ -83,10 +89,23 @@ void MahonyFilterTask()
         Bmx055GetData(&imuData);
         float sampleTime = GetTimeElapsed(&lastTimeCalled, true);
 
+        /** unfiltered acc for vertical estimator, low pass lag would delay climb rate **/
+        quaternion_t rawAccQuat = {.w = 0, .v = {imuData.ax,imuData.ay,imuData.az}};
+
         DigitalFilterProcess(filterHandleAx, imuData.ax, &(imuData.ax));
         DigitalFilterProcess(filterHandleAy, imuData.ay, &(imuData.ay));
         DigitalFilterProcess(filterHandleAz, imuData.az, &(imuData.az));
 
+        /** remove motor noise harmonics from gyro, notches follow bidirectional DShot rpm,
+         *  at this sample rate harmonics above 480Hz stay in gyro signal, 3-rd from 9600rpm **/
+        if(MotorTelemetryUpdate())
+        {
+            float rpm[MOTORS_COUNT];
+            uint8_t validMask = MotorTelemetryGetRpm(rpm);
+            RpmFilterUpdate(rpm, validMask);
+        }
+        vector_t gyro = RpmFilterApply((vector_t){imuData.gx,imuData.gy,imuData.gz});
+
         /** calc estimated acc and mag vector positions based on last iteration **/
         quaternion_t accEstimate = QuatProd(QuatProd(QuatInv(orientation),initialAccQuatVector),orientation);
         quaternion_t magEstimate = QuatProd(QuatProd(QuatInv(orientation),initialMagQuatVector),orientation);
@@ -104,7 +123,7 @@ void MahonyFilterTask()
         quaternion_t accError = QuatMultiply(QuatProd(QuatInv(accEstimate),accQuat),ACC_GAIN);
         quaternion_t magError = QuatMultiply(QuatProd(QuatInv(magEstimate),magQuat),MAG_GAIN);
 
-        quaternion_t gyroQuat = {.w = 0, .v = {imuData.gx,imuData.gy,imuData.gz}};
+        quaternion_t gyroQuat = {.w = 0, .v = gyro};
 
         if(!useMagnetometer)
         {
@@ -118,6 +137,11 @@ void MahonyFilterTask()
         orientation = QuatSum(QuatMultiply(QuatProd(orientation,QuatSum(gyroQuat,QuatSum(accError,magError))),sampleTime/2),orientation);
         orientation = QuatNorm(orientation);
 
+        /** rotate acc to earth frame, component along reference acc vector is 1g at rest **/
+        quaternion_t earthAcc = QuatProd(QuatProd(orientation,rawAccQuat),QuatInv(orientation));
+        float verticalAcc = (VectorDotProd(earthAcc.v,initialAccQuatVector.v)-1.0f)*EARTH_GRAVITY_ACC;
+        AltitudeUpdateAcceleration(verticalAcc, sampleTime);
+
         vTaskDelayUntil(&lastTickTime,1);
     }
 }
@@ -9,12 +9,21 @@
 
 #include "middleware/memory/memory.h"
 
+#include "app/deviceManager/deviceManager.h"
+
+#include "cmsis_os.h"
 #include <string.h>
 
 /*****************************************************************************
                           PRIVATE DEFINES / MACROS
 *****************************************************************************/
 
+#define MEMORY_MAINTENANCE_PERIOD_MS (1000U)  ///< [ms] eeprom compaction check period
+
+#define MASK_WORDS ((EEPROM_VARIABLE_COUNT+31U)/32U)   ///< 32bit words of bit per index mask
+
+#define MASK_GET(mask, index) (((mask)[(index)/32U]&(1U<<((index)%32U))) != 0)
+#define MASK_SET(mask, index) ((mask)[(index)/32U] |= 1U<<((index)%32U))
 
 
 /*****************************************************************************
@@ -23,11 +32,32 @@
 
 static void* registeredVariables[EEPROM_VARIABLE_COUNT];
 
+/** last value persisted in eeprom, variable is written only if it differs **/
+static uint32_t shadow[EEPROM_VARIABLE_COUNT];
+static uint32_t shadowValidMask[MASK_WORDS];    ///< bit per index, cleared if eeprom has no value yet
+
+/** batch buffers, used under eeprom lock to keep callers stacks small **/
+static eepromIndexes_t batchIndexes[EEPROM_VARIABLE_COUNT];
+static uint32_t batchValues[EEPROM_VARIABLE_COUNT];
+
+/** sector erase and arming exclude each other, both flags are changed in critical section **/
+static bool eraseInProgress = false;
+static bool eraseBlocked = false;       ///< set by device manager while armed
+
+/** serializes eeprom writes with background compaction **/
+static StaticSemaphore_t eepromMutexBuffer;
+static SemaphoreHandle_t eepromMutex = NULL;
+
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
 
-
+/**@brief compares registered variables with shadow copy
+ *
+ * @param [out] dirtyMask - bit per index of variables that need to be written
+ * @return true if any variable needs to be written
+ */
+static bool GetDirtyMask(uint32_t dirtyMask[MASK_WORDS]);
 
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
@@ -36,6 +66,64 @@ static void* registeredVariables[EEPROM_VARIABLE_COUNT];
 void MemoryInit()
 {
     memset(registeredVariables, 0, sizeof(registeredVariables));
+    memset(shadowValidMask, 0, sizeof(shadowValidMask));
+    eepromMutex = xSemaphoreCreateMutexStatic(&eepromMutexBuffer);
+}
+
+void MemoryTask()
+{
+    while(1)
+    {
+        xSemaphoreTake(eepromMutex, portMAX_DELAY);
+
+        /** sector erase stalls CPU including control loop and imu sampling,
+         *  never do it while armed or calibrating, mode is checked under lock right before erase **/
+        taskENTER_CRITICAL();
+        deviceOperatingModes_t mode = DeviceManagerGetOperatingMode();
+        bool eraseAllowed = !eraseBlocked &&
+                            (mode == DEVICE_STANDBY || mode == DEVICE_SETTINGS || mode == DEVICE_ERROR);
+        eraseInProgress = eraseAllowed;
+        taskEXIT_CRITICAL();
+
+        EepromMaintenance(eraseAllowed);
+
+        taskENTER_CRITICAL();
+        eraseInProgress = false;
+        taskEXIT_CRITICAL();
+
+        xSemaphoreGive(eepromMutex);
+
+        osDelay(MEMORY_MAINTENANCE_PERIOD_MS);
+    }
+}
+
+bool MemoryEraseInProgress()
+{
+    taskENTER_CRITICAL();
+    bool inProgress = eraseInProgress;
+    taskEXIT_CRITICAL();
+
+    return inProgress;
+}
+
+void MemoryBlockErase()
+{
+    taskENTER_CRITICAL();
+    eraseBlocked = true;
+    taskEXIT_CRITICAL();
+
+    /** erase started before blocking cannot be interrupted, it is finished first **/
+    while(MemoryEraseInProgress())
+    {
+        osDelay(1);
+    }
+}
+
+void MemoryUnblockErase()
+{
+    taskENTER_CRITICAL();
+    eraseBlocked = false;
+    taskEXIT_CRITICAL();
 }
 
 bool MemoryRegisterVariable(eepromIndexes_t index, void* address)
@@ -47,28 +135,77 @@ bool MemoryRegisterVariable(eepromIndexes_t index, void* address)
 
     registeredVariables[index] = address;
 
+    if(EepromRead(index, &shadow[index]))
+    {
+        MASK_SET(shadowValidMask, index);
+    }
+
     return true;
 }
 
 bool MemorySaveRegisteredVariables()
 {
+    uint32_t dirtyMask[MASK_WORDS];
+    uint32_t count = 0;
+
+    if(!GetDirtyMask(dirtyMask))
+    {
+        return true;
+    }
+
+    xSemaphoreTake(eepromMutex, portMAX_DELAY);
+
     for(eepromIndexes_t index=0; index<EEPROM_VARIABLE_COUNT; index++)
     {
-        if(registeredVariables[index] == NULL)
+        if(MASK_GET(dirtyMask, index))
         {
-            continue;
+            batchIndexes[count] = index;
+            memcpy(&batchValues[count], registeredVariables[index], sizeof(uint32_t));
+            count++;
         }
+    }
 
-        if(!EepromWrite(index, registeredVariables[index]))
+    bool status = EepromWriteBatch(batchIndexes, batchValues, count);
+
+    if(status)
+    {
+        for(uint32_t i=0; i<count; i++)
         {
-            return false;
+            shadow[batchIndexes[i]] = batchValues[i];
+            MASK_SET(shadowValidMask, batchIndexes[i]);
         }
     }
 
-    return true;
+    xSemaphoreGive(eepromMutex);
+
+    return status;
 }
 
 /******************************************************************************
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
 
+static bool GetDirtyMask(uint32_t dirtyMask[MASK_WORDS])
+{
+    bool dirty = false;
+    memset(dirtyMask, 0, MASK_WORDS*sizeof(uint32_t));
+
+    for(eepromIndexes_t index=0; index<EEPROM_VARIABLE_COUNT; index++)
+    {
+        if(registeredVariables[index] == NULL)
+        {
+            continue;
+        }
+
+        uint32_t value;
+        memcpy(&value, registeredVariables[index], sizeof(value));
+
+        if(!MASK_GET(shadowValidMask, index) || value != shadow[index])
+        {
+            MASK_SET(dirtyMask, index);
+            dirty = true;
+        }
+    }
+
+    return dirty;
+}
@@ -23,11 +23,32 @@
                          PUBLIC INTERFACE DECLARATION
 *****************************************************************************/
 
-/**@brief initializes registeredVariables array
+/**@brief initializes registeredVariables array and eeprom lock
  */
 void MemoryInit();
 
-/**@brief adds variable address to registered variables
+/**@brief freertos task, runs eeprom maintenance in background,
+ *        sector erase is done only while disarmed
+ */
+void MemoryTask();
+
+/**@brief checks if background maintenance is allowed to erase sector right now
+ *
+ * @return true if erase is in progress
+ */
+bool MemoryEraseInProgress();
+
+/**@brief blocks background sector erase, called by device manager when arming,
+ *        waits until erase that was already in progress is finished
+ */
+void MemoryBlockErase();
+
+/**@brief allows background sector erase again, called after disarming
+ */
+void MemoryUnblockErase();
+
+/**@brief adds variable address to registered variables,
+ *        value currently stored in eeprom is taken as shadow copy
  *
  * @param [in] index - variable index
  * @param [in] address - address of 32bit variable
@@ -35,7 +56,8 @@ void MemoryInit();
  */
 bool MemoryRegisterVariable(eepromIndexes_t index, void* address);
 
-/**@brief takes data from all registered variables and stores it in EEPROM
+/**@brief stores registered variables that differ from last persisted value,
+ *        all changed variables are written in one eeprom batch
  *
  * @return true if successful
  */
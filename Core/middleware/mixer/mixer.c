@@ -0,0 +1,202 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/mixer/mixer.c
+ *
+ * @brief Source code
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/mixer/mixer.h"
+
+#include <stddef.h>
+#include <math.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define SIN_30 (0.5f)
+#define COS_30 (0.866025f)
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+/**@brief single motor row of mixing matrix **/
+typedef struct{
+    float x;
+    float y;
+    float z;
+}mixerRow_t;
+
+typedef struct{
+    uint8_t motorCount;
+    mixerRow_t rows[MIXER_MAX_MOTORS];
+}mixerMatrix_t;
+
+/** +x is left side, +y is back side, +z are motors spinning in the same direction **/
+static const mixerMatrix_t matrices[MIXER_GEOMETRY_COUNT] = {
+    [MIXER_QUAD_X] = {4, {
+        { 1,  1,  1},   ///< back left
+        { 1, -1, -1},   ///< front left
+        {-1,  1, -1},   ///< back right
+        {-1, -1,  1},   ///< front right
+    }},
+    [MIXER_QUAD_PLUS] = {4, {
+        { 0,  1,  1},   ///< back
+        { 1,  0, -1},   ///< left
+        {-1,  0, -1},   ///< right
+        { 0, -1,  1},   ///< front
+    }},
+    [MIXER_HEX_X] = {6, {
+        {-SIN_30, -COS_30,  1}, ///< front right
+        {-1,       0,      -1}, ///< right
+        {-SIN_30,  COS_30,  1}, ///< back right
+        { SIN_30,  COS_30, -1}, ///< back left
+        { 1,       0,       1}, ///< left
+        { SIN_30, -COS_30, -1}, ///< front left
+    }},
+};
+
+static const mixerMatrix_t* matrix = &matrices[MIXER_QUAD_X];
+
+/** thrust linearization, power = sqrt(thrust*linearizationReciprocal+linearizationB^2)-linearizationB **/
+static float linearization = 0;
+static float linearizationReciprocal = 0;
+static float linearizationB = 0;
+
+static float voltageCompensation = 1;
+static float thrustLimit = 1;   ///< max thrust for which compensated output is not above 1
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief recalculates thrustLimit after linearization or compensation change
+ */
+static void UpdateThrustLimit();
+
+/**@brief converts thrust to power using thrust curve
+ *
+ * @param [in] thrust - range 0:1
+ * @return power
+ */
+static float Linearize(float thrust);
+
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+bool MixerInit(mixerGeometry_t geometry)
+{
+    if(geometry >= MIXER_GEOMETRY_COUNT)
+    {
+        return false;
+    }
+
+    matrix = &matrices[geometry];
+
+    return true;
+}
+
+uint8_t MixerGetMotorCount()
+{
+    return matrix->motorCount;
+}
+
+void MixerSetThrustLinearization(float newLinearization)
+{
+    if(newLinearization > 1){newLinearization = 1;}
+    if(newLinearization < 0){newLinearization = 0;}
+
+    linearization = newLinearization;
+    if(linearization > 0)
+    {
+        linearizationReciprocal = 1/linearization;
+        linearizationB = (1-linearization)/(2*linearization);
+    }
+
+    UpdateThrustLimit();
+}
+
+void MixerSetVoltageCompensation(float compensation)
+{
+    if(compensation > MIXER_VOLTAGE_COMPENSATION_MAX){compensation = MIXER_VOLTAGE_COMPENSATION_MAX;}
+    if(compensation < 1){compensation = 1;}
+
+    voltageCompensation = compensation;
+
+    UpdateThrustLimit();
+}
+
+void MixerMix(float throttle, float x, float y, float z, float output[MIXER_MAX_MOTORS])
+{
+    if(output == NULL)
+    {
+        return;
+    }
+
+    float min = 0;
+    float max = 0;
+
+    for(uint8_t i=0; i<matrix->motorCount; i++)
+    {
+        output[i] = matrix->rows[i].x*x + matrix->rows[i].y*y + matrix->rows[i].z*z;
+
+        if(output[i] < min){min = output[i];}
+        if(output[i] > max){max = output[i];}
+    }
+
+    float limit = thrustLimit;
+
+    /** differential part does not fit at any throttle, scale it down **/
+    float scale = 1;
+    if(max-min > limit)
+    {
+        scale = limit/(max-min);
+        min *= scale;
+        max *= scale;
+    }
+
+    if(throttle > limit){throttle = limit;}
+    if(throttle < 0){throttle = 0;}
+
+    /** airmode, move throttle so no motor saturates **/
+    if(throttle+max > limit)
+    {
+        throttle = limit-max;
+    }
+    if(throttle+min < 0)
+    {
+        throttle = -min;
+    }
+
+    float compensation = voltageCompensation;
+    for(uint8_t i=0; i<matrix->motorCount; i++)
+    {
+        output[i] = Linearize(throttle+output[i]*scale)*compensation;
+    }
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static void UpdateThrustLimit()
+{
+    float power = 1/voltageCompensation;
+
+    thrustLimit = (1-linearization)*power+linearization*power*power;
+}
+
+static float Linearize(float thrust)
+{
+    if(linearization <= 0 || thrust <= 0)
+    {
+        return thrust;
+    }
+
+    return sqrtf(thrust*linearizationReciprocal+linearizationB*linearizationB)-linearizationB;
+}
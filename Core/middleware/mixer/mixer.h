@@ -0,0 +1,77 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/mixer/mixer.h
+ *
+ * @brief Header file
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define MIXER_MAX_MOTORS (6U)
+
+#define MIXER_VOLTAGE_COMPENSATION_MAX (1.3f)   ///< max output boost for sagging battery
+
+/**@brief frame geometries, motor order equals mixer output order
+ *        QUAD_X:    back left, front left, back right, front right (motors_t order)
+ *        QUAD_PLUS: back, left, right, front
+ *        HEX_X:     front right, right, back right, back left, left, front left
+ */
+typedef enum{
+    MIXER_QUAD_X = 0,
+    MIXER_QUAD_PLUS,
+    MIXER_HEX_X,
+    MIXER_GEOMETRY_COUNT
+}mixerGeometry_t;
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief selects mixing matrix
+ *
+ * @param [in] geometry
+ * @return true if successful
+ */
+bool MixerInit(mixerGeometry_t geometry);
+
+/**@brief getter for motor count of selected geometry
+ *
+ * @return motor count
+ */
+uint8_t MixerGetMotorCount();
+
+/**@brief sets thrust curve used to linearize outputs, thrust = (1-linearization)*power+linearization*power^2
+ *
+ * @param [in] linearization - range 0:1, 0 disables linearization
+ */
+void MixerSetThrustLinearization(float linearization);
+
+/**@brief sets factor by which outputs are multiplied to keep thrust per command with sagging battery,
+ *        usually reference voltage / battery voltage, cheap enough to be called every few ms
+ *
+ * @param [in] compensation - range 1:MIXER_VOLTAGE_COMPENSATION_MAX, values outside are set to maximums
+ */
+void MixerSetVoltageCompensation(float compensation);
+
+/**@brief mixes throttle and x,y,z axis commands into motor powers in one pass
+ *        if differential commands do not fit into 0:1 at given throttle, throttle is moved
+ *        (airmode) so that differential authority is kept, if they do not fit at any throttle
+ *        they are scaled down
+ *        mixing is done in thrust domain, outputs are linearized and multiplied by voltage compensation,
+ *        thrust range is reduced so compensated outputs never saturate
+ *
+ * @param [in] throttle - range 0:1
+ * @param [in] x - X axis command
+ * @param [in] y - Y axis command
+ * @param [in] z - Z axis command
+ * @param [out] output - MixerGetMotorCount() motor powers in range 0:1
+ */
+void MixerMix(float throttle, float x, float y, float z, float output[MIXER_MAX_MOTORS]);
@@ -0,0 +1,187 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/motorTelemetry/motorTelemetry.c
+ *
+ * @brief Source code
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "app/deviceManager/deviceManager.h"
+
+#include "middleware/motorTelemetry/motorTelemetry.h"
+
+#include "cmsis_os.h"
+
+#include <string.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+static motorsTelemetry_t telemetry = {0};
+
+static volatile uint8_t failedMotors = 0;
+
+/** [ms] tick at which motor started failing, valid if motor bit is set in failingMotors **/
+static TickType_t failingSince[MOTORS_COUNT];
+static uint8_t failingMotors = 0;
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief compares motor speeds with commanded power
+ *
+ * @param [in] power - MOTORS_COUNT values indexed by motors_t
+ * @return bit per motor, set if motor is too slow now
+ */
+static uint8_t CheckMotors(const float power[MOTORS_COUNT]);
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+bool MotorTelemetryUpdate()
+{
+    motorsTelemetry_t newTelemetry;
+    if(!MotorsGetTelemetry(&newTelemetry))
+    {
+        return false;
+    }
+
+    vTaskSuspendAll();
+    telemetry = newTelemetry;
+    xTaskResumeAll();
+
+    float power[MOTORS_COUNT];
+    MotorsGetPower(power);
+
+    bool stopped = true;
+    for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+    {
+        stopped &= power[motor] <= 0;
+    }
+
+    if(stopped)
+    {
+        failingMotors = 0;
+        failedMotors = 0;
+        return true;
+    }
+
+    TickType_t now = xTaskGetTickCount();
+    uint8_t slowMotors = CheckMotors(power);
+    uint8_t newFailures = 0;
+
+    for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+    {
+        uint8_t bit = 1U<<motor;
+        if(!(slowMotors & bit))
+        {
+            failingMotors &= ~bit;
+            continue;
+        }
+
+        if(!(failingMotors & bit))
+        {
+            failingMotors |= bit;
+            failingSince[motor] = now;
+        }
+
+        if(!(failedMotors & bit) && now-failingSince[motor] >= pdMS_TO_TICKS(MOTOR_TELEMETRY_FAILURE_TIME_MS))
+        {
+            newFailures |= bit;
+        }
+    }
+
+    if(newFailures != 0)
+    {
+        failedMotors |= newFailures;
+        DeviceManagerPostEvent(DM_EVENT_MOTOR_FAILURE);
+    }
+
+    return true;
+}
+
+uint8_t MotorTelemetryGetRpm(float rpm[MOTORS_COUNT])
+{
+    if(rpm == NULL)
+    {
+        return 0;
+    }
+
+    vTaskSuspendAll();
+    memcpy(rpm, telemetry.rpm, sizeof(telemetry.rpm));
+    uint8_t validMask = telemetry.validMask;
+    xTaskResumeAll();
+
+    return validMask;
+}
+
+uint8_t MotorTelemetryGetFailedMotors()
+{
+    return failedMotors;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static uint8_t CheckMotors(const float power[MOTORS_COUNT])
+{
+    uint8_t checked = 0;
+    float ratio[MOTORS_COUNT];
+    float ratioSum = 0;
+    uint8_t ratioCount = 0;
+
+    for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+    {
+        if(power[motor] < MOTOR_TELEMETRY_FAILURE_POWER_TRH)
+        {
+            continue;
+        }
+
+        checked |= 1U<<motor;
+        if(telemetry.validMask & (1U<<motor))
+        {
+            ratio[motor] = telemetry.rpm[motor]/power[motor];
+            ratioSum += ratio[motor];
+            ratioCount++;
+        }
+    }
+
+    uint8_t slowMotors = 0;
+    for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+    {
+        uint8_t bit = 1U<<motor;
+        if(!(checked & bit))
+        {
+            continue;
+        }
+
+        /** ESC that stopped answering is treated as failing motor **/
+        if(!(telemetry.validMask & bit) || telemetry.rpm[motor] < MOTOR_TELEMETRY_FAILURE_MIN_RPM)
+        {
+            slowMotors |= bit;
+            continue;
+        }
+
+        if(ratioCount > 1)
+        {
+            float othersAverage = (ratioSum-ratio[motor])/(float)(ratioCount-1);
+            if(ratio[motor] < MOTOR_TELEMETRY_FAILURE_RATIO*othersAverage)
+            {
+                slowMotors |= bit;
+            }
+        }
+    }
+
+    return slowMotors;
+}
@@ -0,0 +1,50 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/motorTelemetry/motorTelemetry.h
+ *
+ * @brief Header file
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "drivers/motors/motors.h"
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define MOTOR_TELEMETRY_FAILURE_POWER_TRH (0.2f)    ///< only motors commanded above this power are checked
+#define MOTOR_TELEMETRY_FAILURE_MIN_RPM (1000.0f)   ///< [rev/min] checked motor bellow this speed is failing
+#define MOTOR_TELEMETRY_FAILURE_RATIO (0.5f)        ///< checked motor with rpm/power bellow this part of
+                                                    ///< other checked motors average is failing
+#define MOTOR_TELEMETRY_FAILURE_TIME_MS (100U)      ///< [ms] motor needs to be failing this long to be reported
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief reads new telemetry from motors driver and checks motors for failure,
+ *        DM_EVENT_MOTOR_FAILURE is posted when new failed motor is detected,
+ *        failures are cleared when all motors are stopped
+ *        call periodically from single task, faster than MOTOR_TELEMETRY_FAILURE_TIME_MS
+ *
+ * @return true if new telemetry was received
+ */
+bool MotorTelemetryUpdate();
+
+/**@brief getter for latest motor speeds
+ *
+ * @param [out] rpm - [rev/min] MOTORS_COUNT values indexed by motors_t
+ * @return bit per motor, set if rpm of that motor is valid
+ */
+uint8_t MotorTelemetryGetRpm(float rpm[MOTORS_COUNT]);
+
+/**@brief getter for failed motors
+ *
+ * @return bit per motor, set if motor is failing
+ */
+uint8_t MotorTelemetryGetFailedMotors();
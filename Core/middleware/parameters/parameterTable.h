@@ -0,0 +1,52 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/parameters/parameterTable.h
+ *
+ * @brief Table of all tunable and persistent parameters
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include "drivers/motors/motors.h"
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define PARAMETER_LIVE (0x01U)  ///< applied by control loop at next iteration, safe to change in flight
+
+/**@brief PARAMETER(name, type, default, min, max, scale, key, flags)
+ *  - type - FLOAT or INT32, every parameter takes one 32bit eeprom cell
+ *  - min, max - set values are clamped, stored values out of range are replaced with default
+ *  - scale - value change per dial unit in remote settings menu, 0 hides parameter from menu,
+ *            menu items are numbered in table order
+ *  - key - eeprom index 1::EEPROM_PARAMETERS_KEY_LAST, EEPROM_NO_KEY if not persistent,
+ *          key of removed parameter must never be given to a new one
+ *  - flags - PARAMETER_LIVE if parameter can be changed while motors are armed
+ *
+ * @warning changing name, type or key of persistent parameter changes schema hash,
+ *          stored value of parameter with changed name or type is replaced with default at boot
+ */
+#define PARAMETERS_TABLE(PARAMETER) \
+    PARAMETER(CALIBRATION,     FLOAT, 0.0f,            -10.0f,   10.0f,  10.0f, EEPROM_NO_KEY, 0) \
+    PARAMETER(PID_XY_P,        FLOAT, 0.1f,              0.0f,   10.0f,  0.01f, 10,            PARAMETER_LIVE) \
+    PARAMETER(PID_XY_I,        FLOAT, 0.01f,             0.0f,   10.0f,  0.01f, 11,            PARAMETER_LIVE) \
+    PARAMETER(PID_XY_D,        FLOAT, 0.02f,             0.0f,   10.0f,  0.01f, 12,            PARAMETER_LIVE) \
+    PARAMETER(PID_Z_P,         FLOAT, 0.1f,              0.0f,   10.0f,  0.01f, 13,            PARAMETER_LIVE) \
+    PARAMETER(PID_Z_I,         FLOAT, 0.01f,             0.0f,   10.0f,  0.01f, 14,            PARAMETER_LIVE) \
+    PARAMETER(PID_Z_D,         FLOAT, 0.05f,             0.0f,   10.0f,  0.01f, 15,            PARAMETER_LIVE) \
+    PARAMETER(PID_N,           FLOAT, 70.0f,             1.0f, 1000.0f,  10.0f, 16,            PARAMETER_LIVE) \
+    PARAMETER(ESC_PROTOCOL,    FLOAT, MOTORS_PROTOCOL,   0.0f, MOTORS_PROTOCOL_COUNT-1, 7.0f, 17,            0) \
+    PARAMETER(PID_XY_FF,       FLOAT, 0.0f,              0.0f,    1.0f,  0.01f, 18,            PARAMETER_LIVE) \
+    PARAMETER(PID_Z_FF,        FLOAT, 0.0f,              0.0f,    1.0f,  0.01f, 19,            PARAMETER_LIVE) \
+    PARAMETER(HOVER_THROTTLE,  FLOAT, 0.5f,              0.2f,    0.8f,  0.01f, 20,            PARAMETER_LIVE) \
+    PARAMETER(ACC_OFFSET_X,    FLOAT, 0.0f,            -20.0f,   20.0f,   0.0f, 1,             0) \
+    PARAMETER(ACC_OFFSET_Y,    FLOAT, 0.0f,            -20.0f,   20.0f,   0.0f, 2,             0) \
+    PARAMETER(ACC_OFFSET_Z,    FLOAT, 0.0f,            -20.0f,   20.0f,   0.0f, 3,             0) \
+    PARAMETER(GYRO_OFFSET_X,   FLOAT, 0.0f,             -2.0f,    2.0f,   0.0f, 4,             0) \
+    PARAMETER(GYRO_OFFSET_Y,   FLOAT, 0.0f,             -2.0f,    2.0f,   0.0f, 5,             0) \
+    PARAMETER(GYRO_OFFSET_Z,   FLOAT, 0.0f,             -2.0f,    2.0f,   0.0f, 6,             0) \
+    PARAMETER(MAG_OFFSET_X,    FLOAT, 0.0f,          -1000.0f, 1000.0f,   0.0f, 7,             0) \
+    PARAMETER(MAG_OFFSET_Y,    FLOAT, 0.0f,          -1000.0f, 1000.0f,   0.0f, 8,             0) \
+    PARAMETER(MAG_OFFSET_Z,    FLOAT, 0.0f,          -1000.0f, 1000.0f,   0.0f, 9,             0)
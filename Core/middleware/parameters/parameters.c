@@ -0,0 +1,291 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/parameters/parameters.c
+ *
+ * @brief Source code
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/parameters/parameters.h"
+
+#include "middleware/memory/memory.h"
+
+#include "drivers/uart/uart.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define FNV_OFFSET_BASIS (2166136261U)
+#define FNV_PRIME (16777619U)
+
+#define PARAMETER_DESCRIPTOR(name, type, defaultValue, min, max, scale, key, flags) \
+    {#name, PARAMETER_TYPE_##type, (float)(defaultValue), (float)(min), (float)(max), (scale), (eepromIndexes_t)(key), (flags), offsetof(parametersValues_t, name)},
+
+#define PARAMETER_DEFAULT(name, type, defaultValue, min, max, scale, key, flags) .name = (PARAMETER_CTYPE_##type)(defaultValue),
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+parametersValues_t parametersValues = {
+    PARAMETERS_TABLE(PARAMETER_DEFAULT)
+};
+
+static const parameterDescriptor_t descriptors[PARAMETERS_COUNT] = {
+    PARAMETERS_TABLE(PARAMETER_DESCRIPTOR)
+};
+
+static uint32_t schemaHash = 0;
+
+/** hash of name and type per parameter, stored next to values to find entries changed under the same key **/
+static uint32_t signatures[PARAMETERS_COUNT];
+
+_Static_assert(sizeof(parametersValues_t) == PARAMETERS_COUNT*sizeof(uint32_t), "every parameter needs to be 32bit wide");
+_Static_assert(EEPROM_PARAMETERS_KEY_LAST < 64, "key usage is tracked in 64bit mask");
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief calculates FNV-1a hash of persistent part of parameter table
+ *
+ * @return hash
+ */
+static uint32_t CalculateSchemaHash();
+
+/**@brief calculates FNV-1a hash of name and type of parameter
+ *
+ * @param [in] descriptor
+ * @return signature
+ */
+static uint32_t CalculateSignature(const parameterDescriptor_t* descriptor);
+
+/**@brief checks if value stored under key of parameter was written for the same parameter,
+ *        only called when stored schema hash differs from current one
+ *
+ * @param [in] id - valid persistent parameter id
+ * @return false if stored signature exists and differs, value has to be replaced with default
+ */
+static bool StoredValueCompatible(parameterId_t id);
+
+/**@brief continues FNV-1a hash with given bytes
+ *
+ * @param [in] hash
+ * @param [in] data
+ * @param [in] size
+ * @return hash
+ */
+static uint32_t HashBytes(uint32_t hash, const void* data, uint32_t size);
+
+/**@brief pointer to value of parameter inside parametersValues
+ *
+ * @param [in] id - valid parameter id
+ * @return pointer to 32bit value
+ */
+static void* GetValueAddress(parameterId_t id);
+
+/**@brief converts raw 32bit value of parameter to float
+ *
+ * @param [in] id - valid parameter id
+ * @param [in] raw
+ * @return value
+ */
+static float RawToFloat(parameterId_t id, uint32_t raw);
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+bool ParametersInit()
+{
+    schemaHash = CalculateSchemaHash();
+    uint64_t usedKeys = 0;
+
+    /** same hash means same table, values are loaded directly,
+     *  otherwise every entry is checked with its signature, no stored hash means firmware before schema tracking **/
+    uint32_t storedSchemaHash;
+    bool schemaChanged = EepromRead(EEPROM_PARAMETERS_SCHEMA, &storedSchemaHash) && storedSchemaHash != schemaHash;
+    if(schemaChanged)
+    {
+        UartWrite("parameters: schema changed 0x%x -> 0x%x, migrating\r\n", storedSchemaHash, schemaHash);
+    }
+
+    for(parameterId_t id=0; id<PARAMETERS_COUNT; id++)
+    {
+        const parameterDescriptor_t* descriptor = &descriptors[id];
+        if(descriptor->key == EEPROM_NO_KEY)
+        {
+            continue;
+        }
+
+        if(descriptor->key > EEPROM_PARAMETERS_KEY_LAST || (usedKeys&(1ULL<<descriptor->key)) != 0)
+        {
+            return false;
+        }
+        usedKeys |= 1ULL<<descriptor->key;
+
+        signatures[id] = CalculateSignature(descriptor);
+
+        /** value under changed signature (renamed or retyped parameter) is replaced with default,
+         *  range is checked for all values to reject garbage **/
+        uint32_t raw;
+        if((!schemaChanged || StoredValueCompatible(id)) && EepromRead(descriptor->key, &raw))
+        {
+            float value = RawToFloat(id, raw);
+            if(isfinite(value) && value >= descriptor->min && value <= descriptor->max)
+            {
+                memcpy(GetValueAddress(id), &raw, sizeof(raw));
+            }
+        }
+
+        if(!MemoryRegisterVariable(descriptor->key, GetValueAddress(id)) ||
+           !MemoryRegisterVariable(EEPROM_PARAMETERS_SIGNATURES+descriptor->key, &signatures[id]))
+        {
+            return false;
+        }
+    }
+
+    /** hash and signatures are written with next save, migration is repeated on every boot until then **/
+    if(!MemoryRegisterVariable(EEPROM_PARAMETERS_SCHEMA, &schemaHash))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+const parameterDescriptor_t* ParametersGetDescriptor(parameterId_t id)
+{
+    if(id >= PARAMETERS_COUNT)
+    {
+        return NULL;
+    }
+
+    return &descriptors[id];
+}
+
+bool ParametersSet(parameterId_t id, float value)
+{
+    if(id >= PARAMETERS_COUNT || isnan(value))
+    {
+        return false;
+    }
+
+    const parameterDescriptor_t* descriptor = &descriptors[id];
+    value = value < descriptor->min ? descriptor->min : value;
+    value = value > descriptor->max ? descriptor->max : value;
+
+    if(descriptor->type == PARAMETER_TYPE_INT32)
+    {
+        *(int32_t*)GetValueAddress(id) = (int32_t)lroundf(value);
+    } else
+    {
+        *(float*)GetValueAddress(id) = value;
+    }
+
+    return true;
+}
+
+bool ParametersGet(parameterId_t id, float* value)
+{
+    if(id >= PARAMETERS_COUNT || value == NULL)
+    {
+        return false;
+    }
+
+    uint32_t raw;
+    memcpy(&raw, GetValueAddress(id), sizeof(raw));
+    *value = RawToFloat(id, raw);
+
+    return true;
+}
+
+uint32_t ParametersGetSchemaHash()
+{
+    return schemaHash;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static uint32_t CalculateSchemaHash()
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+
+    for(parameterId_t id=0; id<PARAMETERS_COUNT; id++)
+    {
+        const parameterDescriptor_t* descriptor = &descriptors[id];
+        if(descriptor->key == EEPROM_NO_KEY)
+        {
+            continue;
+        }
+
+        uint8_t typeAndKey[2] = {(uint8_t)descriptor->type, (uint8_t)descriptor->key};
+        hash = HashBytes(hash, descriptor->name, strlen(descriptor->name));
+        hash = HashBytes(hash, typeAndKey, sizeof(typeAndKey));
+    }
+
+    return hash;
+}
+
+static uint32_t CalculateSignature(const parameterDescriptor_t* descriptor)
+{
+    uint8_t type = (uint8_t)descriptor->type;
+    uint32_t hash = HashBytes(FNV_OFFSET_BASIS, descriptor->name, strlen(descriptor->name));
+
+    return HashBytes(hash, &type, sizeof(type));
+}
+
+static bool StoredValueCompatible(parameterId_t id)
+{
+    const parameterDescriptor_t* descriptor = &descriptors[id];
+    uint32_t storedSignature;
+
+    if(!EepromRead(EEPROM_PARAMETERS_SIGNATURES+descriptor->key, &storedSignature) ||
+       storedSignature == signatures[id])
+    {
+        return true;
+    }
+
+    UartWrite("parameters: %s changed, default applied\r\n", descriptor->name);
+
+    return false;
+}
+
+static uint32_t HashBytes(uint32_t hash, const void* data, uint32_t size)
+{
+    const uint8_t* bytes = data;
+
+    for(uint32_t i=0; i<size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+static void* GetValueAddress(parameterId_t id)
+{
+    return (uint8_t*)&parametersValues+descriptors[id].offset;
+}
+
+static float RawToFloat(parameterId_t id, uint32_t raw)
+{
+    if(descriptors[id].type == PARAMETER_TYPE_INT32)
+    {
+        return (float)(int32_t)raw;
+    }
+
+    float value;
+    memcpy(&value, &raw, sizeof(value));
+
+    return value;
+}
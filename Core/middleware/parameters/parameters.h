@@ -0,0 +1,106 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/parameters/parameters.h
+ *
+ * @brief Header file
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "drivers/eeprom/eeprom.h"
+#include "middleware/parameters/parameterTable.h"
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define PARAMETER_CTYPE_FLOAT float
+#define PARAMETER_CTYPE_INT32 int32_t
+
+#define PARAMETER_ENUM(name, type, defaultValue, min, max, scale, key, flags) PARAMETER_##name,
+#define PARAMETER_FIELD(name, type, defaultValue, min, max, scale, key, flags) PARAMETER_CTYPE_##type name;
+
+typedef enum{
+    PARAMETER_TYPE_FLOAT = 0,
+    PARAMETER_TYPE_INT32
+}parameterType_t;
+
+typedef enum{
+    PARAMETERS_TABLE(PARAMETER_ENUM)
+
+    PARAMETERS_COUNT
+}parameterId_t;
+
+/**@brief storage of all parameter values, one typed field per table entry
+ */
+typedef struct{
+    PARAMETERS_TABLE(PARAMETER_FIELD)
+}parametersValues_t;
+
+typedef struct{
+    const char* name;
+    parameterType_t type;
+    float defaultValue;
+    float min;
+    float max;
+    float scale;
+    eepromIndexes_t key;
+    uint8_t flags;
+    uint16_t offset;        ///< offset of value in parametersValues_t
+}parameterDescriptor_t;
+
+/**@brief direct access to parameter values, use PARAMETERS_GET for reading
+ *        and ParametersSet for range checked writing
+ */
+extern parametersValues_t parametersValues;
+
+/**@brief O(1) typed read of parameter, name as in PARAMETERS_TABLE, resolved at compile time
+ */
+#define PARAMETERS_GET(name) ((void)0, parametersValues.name)
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief loads persistent parameters from eeprom and registers them in memory,
+ *        values that are missing or out of range are replaced with defaults,
+ *        if stored schema hash differs, values written for other name or type under the same key
+ *        are replaced with defaults too, call after MemoryInit and UartInit
+ *
+ * @return true if successful
+ */
+bool ParametersInit();
+
+/**@brief getter for parameter description
+ *
+ * @param [in] id
+ * @return pointer to descriptor, NULL if id is invalid
+ */
+const parameterDescriptor_t* ParametersGetDescriptor(parameterId_t id);
+
+/**@brief sets parameter, value is clamped to min/max and rounded for INT32 parameters
+ *
+ * @param [in] id
+ * @param [in] value
+ * @return true if successful
+ */
+bool ParametersSet(parameterId_t id, float value);
+
+/**@brief getter of parameter converted to float
+ *
+ * @param [in] id
+ * @param [out] value
+ * @return true if successful
+ */
+bool ParametersGet(parameterId_t id, float* value);
+
+/**@brief hash of names, types and keys of persistent parameters,
+ *        stored in eeprom next to values to detect table changes between firmwares
+ *
+ * @return schema hash
+ */
+uint32_t ParametersGetSchemaHash();
@@ -9,100 +9,254 @@
 
 #include "middleware/pid/pid.h"
 
-#include "drivers/utils/utils.h"
-
-#include <stdlib.h>
+#include <stddef.h>
+#include <math.h>
 
 /*****************************************************************************
                           PRIVATE DEFINES / MACROS
 *****************************************************************************/
 
-#define YVk_1 (((pidData_t*)pidHandle)->prevVelOut)
-#define YIk_1 (((pidData_t*)pidHandle)->prevIntegralOut)
-#define Uk_1  (((pidData_t*)pidHandle)->prevIn)
-#define N     (((pidData_t*)pidHandle)->filterCoefficient)
-#define P     (((pidData_t*)pidHandle)->p)
-#define I     (((pidData_t*)pidHandle)->i)
-#define D     (((pidData_t*)pidHandle)->d)
-
-
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
 *****************************************************************************/
 
-typedef struct{
-    float p;
-    float i;
-    float d;
-    float filterCoefficient;
-
-    float prevIntegralOut;
-    float prevVelOut;
-    float prevIn;
-
-    uint32_t lastTimeCalled;
-}pidData_t;
-
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
 
-
+/**@brief limits value to -limit:limit
+ *
+ * @param [in] value
+ * @param [in] limit - not negative
+ * @return limited value
+ */
+static inline float Limit(float value, float limit);
 
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
 *****************************************************************************/
 
-bool PidInit(pidHandle_t *pidHandle, float p, float i, float d, float filterCoefficient)
+bool PidInit(pidController_t* pid, const pidGains_t* gains)
 {
-    *pidHandle = (uint32_t)malloc(sizeof(pidData_t));
-
-    if(*pidHandle == 0)
+    if(pid == NULL)
     {
         return false;
     }
 
-    ((pidData_t*)*pidHandle)->p = p;
-    ((pidData_t*)*pidHandle)->i = i;
-    ((pidData_t*)*pidHandle)->d = d;
-    ((pidData_t*)*pidHandle)->filterCoefficient = filterCoefficient;
-    ((pidData_t*)*pidHandle)->prevIntegralOut = 0;
-    ((pidData_t*)*pidHandle)->prevIn = 0;
-    ((pidData_t*)*pidHandle)->prevVelOut = 0;
-    ((pidData_t*)*pidHandle)->lastTimeCalled = 0;
+    PidReset(pid);
+
+    return PidSetGains(pid, gains);
+}
+
+void PidReset(pidController_t* pid)
+{
+    pid->integral = 0;
+    pid->derivative = 0;
+    pid->setpointRate = 0;
+    pid->prevMeasurement = 0;
+    pid->prevSetpoint = 0;
+    pid->output = 0;
+    pid->started = false;
+}
+
+bool PidSetGains(pidController_t* pid, const pidGains_t* gains)
+{
+    if(pid == NULL || gains == NULL || gains->filterCoefficient < 0 ||
+       gains->integralLimit < 0 || gains->outputLimit < 0 || gains->trackingGain < 0)
+    {
+        return false;
+    }
 
-    GetTimeElapsed(&(((pidData_t*)*pidHandle)->lastTimeCalled), true);
+    pid->gains = *gains;
+    pid->integral = Limit(pid->integral, gains->integralLimit);
 
     return true;
 }
 
-float PidCalc(pidHandle_t pidHandle, float input)
+float PidCalc(pidController_t* pid, float setpoint, float measurement, float dt)
 {
-    float ts = GetTimeElapsed(&(((pidData_t*)pidHandle)->lastTimeCalled), true);
+    if(!(dt > 0))
+    {
+        return pid->output;
+    }
+
+    if(!pid->started)
+    {
+        pid->prevMeasurement = measurement;
+        pid->prevSetpoint = setpoint;
+        pid->started = true;
+    }
+
+    const pidGains_t* gains = &pid->gains;
+    float error = setpoint-measurement;
+    float inverseDt = 1.0f/dt;
+
+    /** N/(s+N) backward Euler: y += N*dt/(1+N*dt)*(x-y), stable for any dt **/
+    float alpha = 1.0f;
+    if(gains->filterCoefficient > 0)
+    {
+        float ndt = gains->filterCoefficient*dt;
+        alpha = ndt/(1.0f+ndt);
+    }
+
+    pid->derivative += alpha*((measurement-pid->prevMeasurement)*inverseDt - pid->derivative);
+    pid->setpointRate += alpha*((setpoint-pid->prevSetpoint)*inverseDt - pid->setpointRate);
+    pid->prevMeasurement = measurement;
+    pid->prevSetpoint = setpoint;
+
+    float output = gains->p*error + pid->integral - gains->d*pid->derivative + gains->ff*pid->setpointRate;
+    float limited = Limit(output, gains->outputLimit);
+
+    /** back-calculation, integrator is pulled back while output is saturated,
+     *  only towards 0, large P term alone must not build up opposite I term **/
+    float integral = pid->integral + gains->i*error*dt;
+    float unwind = gains->trackingGain*(limited-output)*dt;
+    if(integral*unwind < 0)
+    {
+        integral = fabsf(unwind) > fabsf(integral) ? 0 : integral+unwind;
+    }
+    pid->integral = Limit(integral, gains->integralLimit);
+
+    pid->output = limited;
+
+    return limited;
+}
+
+bool PidBankInit(pidBank_t* bank, const pidGains_t* gains)
+{
+    if(bank == NULL)
+    {
+        return false;
+    }
 
-    /** CALCULATE VELOCITY **/
-    YVk_1 = -YVk_1*(N*ts-1) - Uk_1*N + input*N;
+    PidBankReset(bank);
 
-    /** INTEGRATE INPUT **/
-    YIk_1 = ts*Uk_1 + YIk_1;
+    for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+    {
+        if(!PidBankSetGains(bank, axis, gains))
+        {
+            return false;
+        }
+    }
 
-    Uk_1 = input;
+    return true;
+}
 
-    return P*input + I*YIk_1 + D*YVk_1;
+void PidBankReset(pidBank_t* bank)
+{
+    for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+    {
+        bank->integral[axis] = 0;
+        bank->derivative[axis] = 0;
+        bank->setpointRate[axis] = 0;
+        bank->prevMeasurement[axis] = 0;
+        bank->prevSetpoint[axis] = 0;
+        bank->output[axis] = 0;
+    }
+    bank->started = false;
 }
 
-bool PidSetParam(pidHandle_t pidHandle, pidParameters_t param, float value)
+bool PidBankSetGains(pidBank_t* bank, pidBankAxis_t axis, const pidGains_t* gains)
 {
-    if(pidHandle == 0 || param > PID_N)
+    if(bank == NULL || gains == NULL || axis >= PID_BANK_AXES || gains->filterCoefficient < 0 ||
+       gains->integralLimit < 0 || gains->outputLimit < 0 || gains->trackingGain < 0)
     {
         return false;
     }
-    *(float*)(pidHandle+4*param) = value;
+
+    bank->p[axis] = gains->p;
+    bank->i[axis] = gains->i;
+    bank->d[axis] = gains->d;
+    bank->ff[axis] = gains->ff;
+    bank->filterCoefficient[axis] = gains->filterCoefficient;
+    bank->integralLimit[axis] = gains->integralLimit;
+    bank->outputLimit[axis] = gains->outputLimit;
+    bank->trackingGain[axis] = gains->trackingGain;
+    bank->integral[axis] = Limit(bank->integral[axis], gains->integralLimit);
 
     return true;
 }
 
+void PidBankCalc(pidBank_t* bank, const float setpoint[PID_BANK_AXES], const float measurement[PID_BANK_AXES],
+                 float dt, float output[PID_BANK_AXES])
+{
+    if(!(dt > 0))
+    {
+        for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+        {
+            output[axis] = bank->output[axis];
+        }
+        return;
+    }
+
+    if(!bank->started)
+    {
+        for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+        {
+            bank->prevMeasurement[axis] = measurement[axis];
+            bank->prevSetpoint[axis] = setpoint[axis];
+        }
+        bank->started = true;
+    }
+
+    /** dt dependent terms are calculated once for all axes,
+     *  loops below have fixed trip count and no branches besides limits, compiler unrolls them **/
+    float inverseDt = 1.0f/dt;
+    float alpha[PID_BANK_AXES];
+    for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+    {
+        float ndt = bank->filterCoefficient[axis]*dt;
+        alpha[axis] = ndt > 0 ? ndt/(1.0f+ndt) : 1.0f;
+    }
+
+    float error[PID_BANK_AXES];
+    float unlimited[PID_BANK_AXES];
+    for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+    {
+        error[axis] = setpoint[axis]-measurement[axis];
+
+        bank->derivative[axis] += alpha[axis]*((measurement[axis]-bank->prevMeasurement[axis])*inverseDt - bank->derivative[axis]);
+        bank->setpointRate[axis] += alpha[axis]*((setpoint[axis]-bank->prevSetpoint[axis])*inverseDt - bank->setpointRate[axis]);
+        bank->prevMeasurement[axis] = measurement[axis];
+        bank->prevSetpoint[axis] = setpoint[axis];
+
+        unlimited[axis] = bank->p[axis]*error[axis] + bank->integral[axis]
+                        - bank->d[axis]*bank->derivative[axis] + bank->ff[axis]*bank->setpointRate[axis];
+    }
+
+    for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+    {
+        float limited = Limit(unlimited[axis], bank->outputLimit[axis]);
+
+        /** same back-calculation as PidCalc **/
+        float integral = bank->integral[axis] + bank->i[axis]*error[axis]*dt;
+        float unwind = bank->trackingGain[axis]*(limited-unlimited[axis])*dt;
+        if(integral*unwind < 0)
+        {
+            integral = fabsf(unwind) > fabsf(integral) ? 0 : integral+unwind;
+        }
+        bank->integral[axis] = Limit(integral, bank->integralLimit[axis]);
+
+        bank->output[axis] = limited;
+        output[axis] = limited;
+    }
+}
+
 /******************************************************************************
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
 
+static inline float Limit(float value, float limit)
+{
+    if(value > limit)
+    {
+        return limit;
+    }
+
+    if(value < -limit)
+    {
+        return -limit;
+    }
+
+    return value;
+}
@@ -15,14 +15,60 @@
                        PUBLIC DEFINES / MACROS / ENUMS
 *****************************************************************************/
 
+typedef struct{
+    float p;
+    float i;
+    float d;
+    float ff;                   ///< setpoint rate feed-forward
+    float filterCoefficient;    ///< [rad/s] cut-off of D and feed-forward low pass, 0 disables filter
+    float integralLimit;        ///< max magnitude of I term
+    float outputLimit;          ///< max magnitude of output
+    float trackingGain;         ///< [1/s] back-calculation, rate at which I term unwinds when output saturates
+}pidGains_t;
+
+/**@brief single PID regulator, memory is provided by caller
+ */
+typedef struct{
+    pidGains_t gains;
+
+    float integral;             ///< I term, already multiplied by i
+    float derivative;           ///< filtered measurement rate
+    float setpointRate;         ///< filtered setpoint rate
+    float prevMeasurement;
+    float prevSetpoint;
+    float output;               ///< last output
+    bool started;               ///< false until first sample, rates are 0 on first sample
+}pidController_t;
+
+#define PID_BANK_AXES (3U)
+
 typedef enum{
-    PID_P=0,
-    PID_I,
-    PID_D,
-    PID_N,
-}pidParameters_t;
+    PID_BANK_X = 0,
+    PID_BANK_Y,
+    PID_BANK_Z
+}pidBankAxis_t;
 
-typedef uint32_t pidHandle_t;
+/**@brief PID_BANK_AXES regulators sharing dt, stored as structure of arrays,
+ *        every stage of PidBankCalc runs as one loop over axes on contiguous floats
+ */
+typedef struct{
+    float p[PID_BANK_AXES];
+    float i[PID_BANK_AXES];
+    float d[PID_BANK_AXES];
+    float ff[PID_BANK_AXES];
+    float filterCoefficient[PID_BANK_AXES];
+    float integralLimit[PID_BANK_AXES];
+    float outputLimit[PID_BANK_AXES];
+    float trackingGain[PID_BANK_AXES];
+
+    float integral[PID_BANK_AXES];
+    float derivative[PID_BANK_AXES];
+    float setpointRate[PID_BANK_AXES];
+    float prevMeasurement[PID_BANK_AXES];
+    float prevSetpoint[PID_BANK_AXES];
+    float output[PID_BANK_AXES];
+    bool started;
+}pidBank_t;
 
 /*****************************************************************************
                          PUBLIC INTERFACE DECLARATION
@@ -30,37 +76,73 @@ typedef uint32_t pidHandle_t;
 
 /**@brief initializes discrete PID
  *
- * @param [in] pidHandle
- * @param [in] p
- * @param [in] i
- * @param [in] d
- * @param [in] filterCoefficient - for velocity approximation
+ * @param [out] pid
+ * @param [in] gains
+ * @return true if successful
+ */
+bool PidInit(pidController_t* pid, const pidGains_t* gains);
+
+/**@brief clears integral and derivative state, next PidCalc starts without kick
+ *
+ * @param [in/out] pid
+ */
+void PidReset(pidController_t* pid);
+
+/**@brief changes gains and limits, state is kept,
+ *        integral is stored as I term, so change of i is bumpless
+ *
+ * @param [in/out] pid
+ * @param [in] gains
  * @return true if successful
  */
-bool PidInit(pidHandle_t *pidHandle, float p, float i, float d, float filterCoefficient);
+bool PidSetGains(pidController_t* pid, const pidGains_t* gains);
 
 /**@brief calculates next PID output value
- *        needs to be called regularly with desired sampling frequency
  *
- *         pid model:
+ *         u = P*e + I*integral(e) - D*LPF(dy/dt) + FF*LPF(dr/dt), e = r - y
  *
- *         P + I*Ts/(z-1) + D*N/(1+N*Ts/(z-1))
+ *         derivative is taken from measurement, so setpoint steps do not kick D term,
+ *         I term is clamped to integralLimit and unwound by trackingGain*(saturated - u)
+ *         while output is limited, LPF is backward Euler of N/(s+N)
  *
- *         where this is velocity filter:
+ * @param [in/out] pid
+ * @param [in] setpoint - r
+ * @param [in] measurement - y
+ * @param [in] dt - [s] time since last call, output is held if not positive
+ * @return PID output limited to outputLimit
+ */
+float PidCalc(pidController_t* pid, float setpoint, float measurement, float dt);
+
+/**@brief initializes bank, all axes get the same gains
  *
- *         N/(1+N*Ts/(z-1))
+ * @param [out] bank
+ * @param [in] gains
+ * @return true if successful
+ */
+bool PidBankInit(pidBank_t* bank, const pidGains_t* gains);
+
+/**@brief clears state of all axes, next PidBankCalc starts without kick
  *
- * @param [in] pidHandle
- * @param [in] input input data
- * @return PID output
+ * @param [in/out] bank
  */
-float PidCalc(pidHandle_t pidHandle, float input);
+void PidBankReset(pidBank_t* bank);
 
-/**@brief setter for given pid parameter
+/**@brief changes gains and limits of one axis, state is kept
  *
- * @param [in] pidHandle
- * @param [in] param
- * @param [in] value
+ * @param [in/out] bank
+ * @param [in] axis
+ * @param [in] gains
  * @return true if successful
  */
-bool PidSetParam(pidHandle_t pidHandle, pidParameters_t param, float value);
+bool PidBankSetGains(pidBank_t* bank, pidBankAxis_t axis, const pidGains_t* gains);
+
+/**@brief calculates next output of all axes, same algorithm as PidCalc
+ *
+ * @param [in/out] bank
+ * @param [in] setpoint - PID_BANK_AXES values
+ * @param [in] measurement - PID_BANK_AXES values
+ * @param [in] dt - [s] time since last call, outputs are held if not positive
+ * @param [out] output - PID_BANK_AXES values limited to outputLimit
+ */
+void PidBankCalc(pidBank_t* bank, const float setpoint[PID_BANK_AXES], const float measurement[PID_BANK_AXES],
+                 float dt, float output[PID_BANK_AXES]);
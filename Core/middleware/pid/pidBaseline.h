@@ -0,0 +1,61 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/pid/pidBaseline.h
+ *
+ * @brief Header file
+ *        original PID kept as benchmark reference for PID bank,
+ *        heap allocated handle and own time measurement as it was used in flight
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+typedef enum{
+    PID_BASELINE_P=0,
+    PID_BASELINE_I,
+    PID_BASELINE_D,
+    PID_BASELINE_N,
+}pidBaselineParameters_t;
+
+typedef uintptr_t pidBaselineHandle_t;
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief initializes discrete PID, memory is taken from heap
+ *
+ * @param [out] pidHandle
+ * @param [in] p
+ * @param [in] i
+ * @param [in] d
+ * @param [in] filterCoefficient - for velocity approximation
+ * @return true if successful
+ */
+bool PidBaselineInit(pidBaselineHandle_t *pidHandle, float p, float i, float d, float filterCoefficient);
+
+/**@brief calculates next PID output value, sample time is measured with GetTimeElapsed
+ *
+ *         P + I*Ts/(z-1) + D*N/(1+N*Ts/(z-1))
+ *
+ * @param [in] pidHandle
+ * @param [in] input - control error
+ * @return PID output, not limited
+ */
+float PidBaselineCalc(pidBaselineHandle_t pidHandle, float input);
+
+/**@brief setter for given pid parameter
+ *
+ * @param [in] pidHandle
+ * @param [in] param
+ * @param [in] value
+ * @return true if successful
+ */
+bool PidBaselineSetParam(pidBaselineHandle_t pidHandle, pidBaselineParameters_t param, float value);
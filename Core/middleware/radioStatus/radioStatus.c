@@ -21,18 +21,55 @@
 
 #define CHANNEL_MID_POS (0.5f)
 
+#define RADIO_STATUS_TIMEOUT_MS (20U)       ///< [ms] max time between connection status checks
+#define RADIO_STATUS_MAX_SUBSCRIBERS (2U)
+
 /*****************************************************************************
                      PRIVATE STRUCTS / ENUMS / VARIABLES
 *****************************************************************************/
 
-static float radioChannelCurrentData[RADIO_CHANNEL_COUNT] = {0,0,0,0,0,0};
-static bool radioSignalAvailable = false;
+/** masked radio frame, written only by radio status task **/
+static volatile radioFrame_t currentFrame;
+static volatile uint32_t currentFrameVersion = 0;   ///< incremented after every publish
+
+static volatile bool radioSignalAvailable = false;
+
+static bool throttleOn = false;
+static bool switchOn = false;
+
+static TaskHandle_t radioStatusTaskHandle = NULL;
+
+static TaskHandle_t subscribers[RADIO_STATUS_MAX_SUBSCRIBERS] = {NULL};
+static uint8_t subscribersCount = 0;
 
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
 *****************************************************************************/
 
+/**@brief posts device manager events on connection status,
+ *        throttle and switch changes
+ *
+ * @param [in] frame - masked radio frame
+ * @param [in] connected - current connection status
+ */
+static void PostDeviceManagerEvents(const radioFrame_t* frame, bool connected);
+
+/**@brief scales channels and masks them according to device operating mode
+ *
+ * @param [in/out] frame - frame to mask
+ * @param [in] connected - if false all channels are set to 0
+ */
+static void MaskChannels(radioFrame_t* frame, bool connected);
+
+/**@brief publishes masked frame, readers never wait for this function
+ *
+ * @param [in] frame
+ */
+static void PublishFrame(const radioFrame_t* frame);
 
+/**@brief radio driver frame callback, wakes up radio status task
+ */
+static void FrameReceivedIsr();
 
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
@@ -40,73 +77,95 @@ static bool radioSignalAvailable = false;
 
 void RadioStatusTask()
 {
+    radioStatusTaskHandle = xTaskGetCurrentTaskHandle();
+    RadioSetFrameCallback(&FrameReceivedIsr);
+
+    uint32_t lastSequence = 0;
+    bool frameReceived = false;
+    TickType_t lastFrameTime = 0;
+
     while(1)
     {
-        bool allRadioChannelsAvailable = true;
-        for(radioChannel_t channel=RADIO_CHANNEL_1; channel<RADIO_CHANNEL_COUNT; channel++)
-        {
-            radioChannelData_t data = RadioGetChannelData(channel);
-            if(GetTimeElapsed(&(data.lastUpdateTime), false) > RADIO_STATUS_MAX_DOWN_TIME_S)
-            {
-                radioChannelCurrentData[channel] = 0;
-                allRadioChannelsAvailable = false;
-            } else {
-                if(channel == RADIO_ROLL_CHANNEL ||
-                   channel == RADIO_PITCH_CHANNEL ||
-                   channel == RADIO_YAW_CHANNEL)
-                {
-                    radioChannelCurrentData[channel] = (data.channelData-CHANNEL_MID_POS)*2;
-                } else {
-                    radioChannelCurrentData[channel] = data.channelData;
-                }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RADIO_STATUS_TIMEOUT_MS));
 
-            }
+        radioFrame_t frame;
+        RadioGetFrame(&frame);
 
-            if(DeviceManagerGetOperatingMode() == DEVICE_INITIALIZATION)
-            {
-                radioChannelCurrentData[channel] = 0;
-            }
+        bool newFrame = frame.sequence != 0 && (!frameReceived || frame.sequence != lastSequence);
+        if(newFrame)
+        {
+            lastSequence = frame.sequence;
+            lastFrameTime = xTaskGetTickCount();
+            frameReceived = true;
+        }
 
-            if((DeviceManagerGetOperatingMode() == DEVICE_HOMING) &&
-               (channel == RADIO_DIAL_CHANNEL ||
-               channel == RADIO_SWITCH_CHANNEL ||
-               channel == RADIO_THROTTLE_CHANNEL))
-            {
-                radioChannelCurrentData[channel] = 0;
-            }
+        bool connected = frameReceived &&
+                         (xTaskGetTickCount()-lastFrameTime) <= pdMS_TO_TICKS((uint32_t)(RADIO_STATUS_MAX_DOWN_TIME_S*1000));
 
-            if(DeviceManagerGetOperatingMode() == DEVICE_CALIBRATION &&
-               channel != RADIO_SWITCH_CHANNEL)
-            {
-                radioChannelCurrentData[channel] = 0;
-            }
+        MaskChannels(&frame, connected);
+        PublishFrame(&frame);
+        radioSignalAvailable = connected;
 
-            if(DeviceManagerGetOperatingMode() == DEVICE_SETTINGS &&
-               channel != RADIO_SWITCH_CHANNEL &&
-               channel != RADIO_DIAL_CHANNEL)
-            {
-                radioChannelCurrentData[channel] = 0;
-            }
+        /** events are posted after frame and connection status are published,
+         *  guards of device manager evaluate them when it handles the events **/
+        PostDeviceManagerEvents(&frame, connected);
 
-            if(DeviceManagerGetOperatingMode() == DEVICE_FLIGHT &&
-               channel == RADIO_SWITCH_CHANNEL &&
-               channel == RADIO_DIAL_CHANNEL)
+        if(newFrame)
+        {
+            for(uint8_t i=0; i<subscribersCount; i++)
             {
-                radioChannelCurrentData[channel] = 0;
+                xTaskNotifyGive(subscribers[i]);
             }
         }
+    }
+}
+
+bool RadioStatusSubscribe(TaskHandle_t task)
+{
+    RETURN_IF_TRUE(task == NULL, false)
 
-        radioSignalAvailable = allRadioChannelsAvailable;
+    bool subscribed = false;
 
-        osDelay(20);
+    vTaskSuspendAll();
+    if(subscribersCount < RADIO_STATUS_MAX_SUBSCRIBERS)
+    {
+        subscribers[subscribersCount++] = task;
+        subscribed = true;
     }
+    xTaskResumeAll();
+
+    return subscribed;
+}
+
+bool RadioStatusGetFrame(radioFrame_t* frame)
+{
+    RETURN_IF_TRUE(frame == NULL, false)
+
+    uint32_t version;
+
+    /** retry if radio status task published new frame while copying **/
+    do{
+        version = currentFrameVersion;
+        __DMB();
+
+        frame->sequence = currentFrame.sequence;
+        frame->timestamp = currentFrame.timestamp;
+        for(radioChannel_t channel=RADIO_CHANNEL_1; channel<RADIO_CHANNEL_COUNT; channel++)
+        {
+            frame->channelData[channel] = currentFrame.channelData[channel];
+        }
+
+        __DMB();
+    }while(version != currentFrameVersion);
+
+    return true;
 }
 
 float RadioStatusGetChannelData(radioChannel_t channel)
 {
     ASSERT(channel < RADIO_CHANNEL_COUNT)
 
-    return radioChannelCurrentData[channel];
+    return currentFrame.channelData[channel];
 }
 
 bool RadioStatusGetConnectionStatus()
@@ -118,3 +177,112 @@ bool RadioStatusGetConnectionStatus()
                         PRIVATE FUNCTION IMPLEMENTATION
 ******************************************************************************/
 
+static void MaskChannels(radioFrame_t* frame, bool connected)
+{
+    deviceOperatingModes_t mode = DeviceManagerGetOperatingMode();
+
+    for(radioChannel_t channel=RADIO_CHANNEL_1; channel<RADIO_CHANNEL_COUNT; channel++)
+    {
+        if(!connected)
+        {
+            frame->channelData[channel] = 0;
+        } else if(channel == RADIO_ROLL_CHANNEL ||
+                  channel == RADIO_PITCH_CHANNEL ||
+                  channel == RADIO_YAW_CHANNEL)
+        {
+            frame->channelData[channel] = (frame->channelData[channel]-CHANNEL_MID_POS)*2;
+        }
+
+        if(mode == DEVICE_INITIALIZATION)
+        {
+            frame->channelData[channel] = 0;
+        }
+
+        if((mode == DEVICE_HOMING) &&
+           (channel == RADIO_DIAL_CHANNEL ||
+           channel == RADIO_SWITCH_CHANNEL ||
+           channel == RADIO_THROTTLE_CHANNEL))
+        {
+            frame->channelData[channel] = 0;
+        }
+
+        if(mode == DEVICE_CALIBRATION &&
+           channel != RADIO_SWITCH_CHANNEL)
+        {
+            frame->channelData[channel] = 0;
+        }
+
+        if(mode == DEVICE_SETTINGS &&
+           channel != RADIO_SWITCH_CHANNEL &&
+           channel != RADIO_DIAL_CHANNEL)
+        {
+            frame->channelData[channel] = 0;
+        }
+
+        if(mode == DEVICE_FLIGHT &&
+           channel == RADIO_SWITCH_CHANNEL &&
+           channel == RADIO_DIAL_CHANNEL)
+        {
+            frame->channelData[channel] = 0;
+        }
+    }
+}
+
+static void PublishFrame(const radioFrame_t* frame)
+{
+    /** no other task can run while frame is written, so readers never see it half written **/
+    vTaskSuspendAll();
+
+    currentFrame.sequence = frame->sequence;
+    currentFrame.timestamp = frame->timestamp;
+    for(radioChannel_t channel=RADIO_CHANNEL_1; channel<RADIO_CHANNEL_COUNT; channel++)
+    {
+        currentFrame.channelData[channel] = frame->channelData[channel];
+    }
+
+    __DMB();
+    currentFrameVersion++;
+
+    xTaskResumeAll();
+}
+
+static void FrameReceivedIsr()
+{
+    if(radioStatusTaskHandle == NULL)
+    {
+        return;
+    }
+
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(radioStatusTaskHandle, &higherPriorityTaskWoken);
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
+
+static void PostDeviceManagerEvents(const radioFrame_t* frame, bool connected)
+{
+    uint32_t events = 0;
+
+    if(connected != radioSignalAvailable)
+    {
+        events |= connected ? DM_EVENT_RADIO_RESTORED : DM_EVENT_RADIO_LOST;
+    }
+
+    bool throttle = frame->channelData[RADIO_THROTTLE_CHANNEL] > DEVICE_MANAGER_THROTTLE_OFF_TRH;
+    if(throttle != throttleOn)
+    {
+        events |= throttle ? DM_EVENT_THROTTLE_HIGH : DM_EVENT_THROTTLE_LOW;
+        throttleOn = throttle;
+    }
+
+    bool sw = frame->channelData[RADIO_SWITCH_CHANNEL] > DEVICE_MANAGER_SWITCH_OFF_TRH;
+    if(sw != switchOn)
+    {
+        events |= sw ? DM_EVENT_SWITCH_ON : DM_EVENT_SWITCH_OFF;
+        switchOn = sw;
+    }
+
+    if(events != 0)
+    {
+        DeviceManagerPostEvent((deviceManagerEvent_t)events);
+    }
+}
@@ -13,6 +13,8 @@
 
 #include "drivers/radio/radio.h"
 
+#include "cmsis_os.h"
+
 /*****************************************************************************
                        PUBLIC DEFINES / MACROS / ENUMS
 *****************************************************************************/
@@ -32,9 +34,26 @@
 *****************************************************************************/
 
 /**@brief freertos task
+ *        processes every frame received by radio driver as soon as it arrives
  */
 void RadioStatusTask();
 
+/**@brief registers task to be notified (xTaskNotifyGive) when new radio frame is published,
+ *        task should wait for it with ulTaskNotifyTake
+ *
+ * @param [in] task
+ * @return true if successful
+ */
+bool RadioStatusSubscribe(TaskHandle_t task);
+
+/**@brief copies latest published radio frame, lock free
+ *        channels are scaled and masked the same way as in RadioStatusGetChannelData
+ *
+ * @param [out] frame
+ * @return true if successful
+ */
+bool RadioStatusGetFrame(radioFrame_t* frame);
+
 /**@brief getter for current radio data
  *
  * @param [in] channel
@@ -0,0 +1,236 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/rcProtocol/rcProtocol.c
+ *
+ * @brief Source code
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/rcProtocol/rcProtocol.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define SBUS_FRAME_SIZE (25U)
+#define SBUS_HEADER (0x0FU)
+#define SBUS_FLAGS_BYTE (23U)
+#define SBUS_FLAG_FAILSAFE (0x08U)
+#define SBUS_FOOTER_MASK (0x0FU)    ///< SBUS2 uses upper nibble of footer as slot counter
+#define SBUS_FOOTER (0x00U)
+#define SBUS_FOOTER_SBUS2 (0x04U)
+
+#define CRSF_ADDRESS_FC (0xC8U)
+#define CRSF_ADDRESS_BROADCAST (0x00U)
+#define CRSF_ADDRESS_RECEIVER (0xECU)
+#define CRSF_SYNC_BYTE (0xEEU)      ///< used by some transmitters instead of FC address
+#define CRSF_HEADER_SIZE (2U)       ///< address + length
+#define CRSF_MIN_LENGTH (2U)        ///< type + crc
+#define CRSF_TYPE_RC_CHANNELS (0x16U)
+#define CRSF_RC_CHANNELS_PAYLOAD_SIZE (22U)
+#define CRSF_CRC_POLY (0xD5U)
+
+#define CHANNEL_BITS (11U)
+#define CHANNEL_MASK (0x07FFU)
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief unpacks 16 little endian 11 bit channels
+ *
+ * @param [in] data - 22 bytes of packed channels
+ * @param [out] channels
+ */
+static void UnpackChannels(const uint8_t* data, uint16_t* channels);
+
+static bool FeedSbus(rcProtocolDecoder_t* decoder, uint8_t byte, rcProtocolFrame_t* frame);
+static bool FeedCrsf(rcProtocolDecoder_t* decoder, uint8_t byte, rcProtocolFrame_t* frame);
+
+/**@brief CRC8 with polynomial 0xD5, used by CRSF
+ *
+ * @param [in] data
+ * @param [in] size
+ * @return crc
+ */
+static uint8_t Crc8DvbS2(const uint8_t* data, uint8_t size);
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+void RcProtocolInit(rcProtocolDecoder_t* decoder, rcProtocol_t protocol)
+{
+    if(decoder == NULL)
+    {
+        return;
+    }
+
+    memset(decoder, 0, sizeof(rcProtocolDecoder_t));
+    decoder->protocol = protocol;
+}
+
+void RcProtocolReset(rcProtocolDecoder_t* decoder)
+{
+    if(decoder == NULL)
+    {
+        return;
+    }
+
+    decoder->position = 0;
+    decoder->frameSize = 0;
+}
+
+bool RcProtocolFeed(rcProtocolDecoder_t* decoder, uint8_t byte, rcProtocolFrame_t* frame)
+{
+    if(decoder == NULL || frame == NULL)
+    {
+        return false;
+    }
+
+    if(decoder->protocol == RC_PROTOCOL_SBUS)
+    {
+        return FeedSbus(decoder, byte, frame);
+    }
+
+    return FeedCrsf(decoder, byte, frame);
+}
+
+float RcProtocolNormalize(uint16_t raw)
+{
+    float value = ((float)raw-(float)RC_PROTOCOL_RAW_MIN)/((float)(RC_PROTOCOL_RAW_MAX-RC_PROTOCOL_RAW_MIN));
+
+    if(value > 1){value = 1;}
+    if(value < 0){value = 0;}
+
+    return value;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static bool FeedSbus(rcProtocolDecoder_t* decoder, uint8_t byte, rcProtocolFrame_t* frame)
+{
+    if(decoder->position == 0 && byte != SBUS_HEADER)
+    {
+        return false;
+    }
+
+    decoder->frame[decoder->position++] = byte;
+
+    if(decoder->position < SBUS_FRAME_SIZE)
+    {
+        return false;
+    }
+
+    decoder->position = 0;
+
+    uint8_t footer = decoder->frame[SBUS_FRAME_SIZE-1] & SBUS_FOOTER_MASK;
+    if(footer != SBUS_FOOTER && footer != SBUS_FOOTER_SBUS2)
+    {
+        return false;
+    }
+
+    UnpackChannels(&(decoder->frame[1]), frame->channels);
+    frame->failsafe = (decoder->frame[SBUS_FLAGS_BYTE] & SBUS_FLAG_FAILSAFE) != 0;
+
+    return true;
+}
+
+static bool FeedCrsf(rcProtocolDecoder_t* decoder, uint8_t byte, rcProtocolFrame_t* frame)
+{
+    if(decoder->position == 0 &&
+       byte != CRSF_ADDRESS_FC &&
+       byte != CRSF_ADDRESS_BROADCAST &&
+       byte != CRSF_ADDRESS_RECEIVER &&
+       byte != CRSF_SYNC_BYTE)
+    {
+        return false;
+    }
+
+    if(decoder->position == 1)
+    {
+        if(byte < CRSF_MIN_LENGTH || byte > RC_PROTOCOL_MAX_FRAME_SIZE-CRSF_HEADER_SIZE)
+        {
+            decoder->position = 0;
+            return false;
+        }
+        decoder->frameSize = byte+CRSF_HEADER_SIZE;
+    }
+
+    decoder->frame[decoder->position++] = byte;
+
+    if(decoder->position < CRSF_HEADER_SIZE || decoder->position < decoder->frameSize)
+    {
+        return false;
+    }
+
+    decoder->position = 0;
+
+    /** crc covers type and payload **/
+    uint8_t length = decoder->frame[1];
+    if(Crc8DvbS2(&(decoder->frame[CRSF_HEADER_SIZE]), length-1) != decoder->frame[decoder->frameSize-1])
+    {
+        return false;
+    }
+
+    if(decoder->frame[CRSF_HEADER_SIZE] != CRSF_TYPE_RC_CHANNELS ||
+       length != CRSF_RC_CHANNELS_PAYLOAD_SIZE+CRSF_MIN_LENGTH)
+    {
+        return false;
+    }
+
+    UnpackChannels(&(decoder->frame[CRSF_HEADER_SIZE+1]), frame->channels);
+
+    /** CRSF receivers stop sending channel frames on link loss **/
+    frame->failsafe = false;
+
+    return true;
+}
+
+static void UnpackChannels(const uint8_t* data, uint16_t* channels)
+{
+    uint32_t bits = 0;
+    uint8_t bitCount = 0;
+    uint8_t byteIndex = 0;
+
+    for(uint8_t channel=0; channel<RC_PROTOCOL_CHANNEL_COUNT; channel++)
+    {
+        while(bitCount < CHANNEL_BITS)
+        {
+            bits |= ((uint32_t)data[byteIndex++]) << bitCount;
+            bitCount += 8;
+        }
+
+        channels[channel] = (uint16_t)(bits & CHANNEL_MASK);
+        bits >>= CHANNEL_BITS;
+        bitCount -= CHANNEL_BITS;
+    }
+}
+
+static uint8_t Crc8DvbS2(const uint8_t* data, uint8_t size)
+{
+    uint8_t crc = 0;
+
+    for(uint8_t i=0; i<size; i++)
+    {
+        crc ^= data[i];
+        for(uint8_t bit=0; bit<8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ CRSF_CRC_POLY) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
@@ -0,0 +1,80 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/rcProtocol/rcProtocol.h
+ *
+ * @brief SBUS and CRSF serial receiver frame decoder
+ *        does not depend on HAL, so it can be fed with captured byte streams on host
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define RC_PROTOCOL_CHANNEL_COUNT (16U)
+#define RC_PROTOCOL_MAX_FRAME_SIZE (64U)    ///< [bytes] CRSF max frame size, SBUS frame is 25 bytes
+
+#define RC_PROTOCOL_SBUS_BAUDRATE (100000U) ///< 8E2, inverted
+#define RC_PROTOCOL_CRSF_BAUDRATE (420000U) ///< 8N1
+
+/** raw 11 bit channel values corresponding to 1000us and 2000us PWM pulse **/
+#define RC_PROTOCOL_RAW_MIN (192U)
+#define RC_PROTOCOL_RAW_MAX (1792U)
+
+typedef enum{
+    RC_PROTOCOL_SBUS,
+    RC_PROTOCOL_CRSF
+}rcProtocol_t;
+
+/**@brief decoder state, owned by the caller **/
+typedef struct{
+    rcProtocol_t protocol;
+    uint8_t frame[RC_PROTOCOL_MAX_FRAME_SIZE];
+    uint8_t position;
+    uint8_t frameSize;
+}rcProtocolDecoder_t;
+
+/**@brief single decoded receiver frame **/
+typedef struct{
+    uint16_t channels[RC_PROTOCOL_CHANNEL_COUNT];   ///< raw 11 bit values
+    bool failsafe;                                  ///< receiver has no link, channel values are not valid
+}rcProtocolFrame_t;
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief initializes decoder
+ *
+ * @param [out] decoder
+ * @param [in] protocol
+ */
+void RcProtocolInit(rcProtocolDecoder_t* decoder, rcProtocol_t protocol);
+
+/**@brief drops partially received frame,
+ *        should be called on line idle, as it marks frame boundary for both protocols
+ *
+ * @param [in/out] decoder
+ */
+void RcProtocolReset(rcProtocolDecoder_t* decoder);
+
+/**@brief feeds single received byte to decoder
+ *
+ * @param [in/out] decoder
+ * @param [in] byte - received byte
+ * @param [out] frame - filled only when function returns true
+ * @return true if complete and valid channel frame was decoded
+ */
+bool RcProtocolFeed(rcProtocolDecoder_t* decoder, uint8_t byte, rcProtocolFrame_t* frame);
+
+/**@brief converts raw channel value to range 0..1
+ *
+ * @param [in] raw - raw 11 bit channel value
+ * @return channel value in range 0..1
+ */
+float RcProtocolNormalize(uint16_t raw);
@@ -13,7 +13,7 @@
 
 #include "middleware/soundNotifications/soundNotifications.h"
 #include "middleware/radioStatus/radioStatus.h"
-#include "middleware/memory/memory.h"
+#include "middleware/parameters/parameters.h"
 
 #include <stdlib.h>
 #include <cmsis_os.h>
@@ -46,29 +46,10 @@ typedef enum{
     SWITCH_MENU_ITEM_VALUE
 }switchState_t;
 
-/**@brief all settings variables
+/**@brief parameters available in menu, menu item number is index in this array
  */
-static float variables[RS_VARIABLES_COUNT];
-static const float variablesDefaultValues[] = {
-       0,       ///< RS_CALIBRATION
-       0.1,     ///< RS_PID_XY_P
-       0.01,    ///< RS_PID_XY_I
-       0.02,    ///< RS_PID_XY_D
-       0.1,     ///< RS_PID_Z_P
-       0.01,    ///< RS_PID_Z_I
-       0.05,    ///< RS_PID_Z_D
-       70       ///< RS_PID_N
-};
-static const float variablesMultipliers[] = {
-        10,       ///< RS_CALIBRATION
-        0.01,     ///< RS_PID_XY_P
-        0.01,    ///< RS_PID_XY_I
-        0.01,    ///< RS_PID_XY_D
-        0.01,     ///< RS_PID_Z_P
-        0.01,    ///< RS_PID_Z_I
-        0.01,    ///< RS_PID_Z_D
-        10       ///< RS_PID_N
-};
+static parameterId_t menuItems[PARAMETERS_COUNT];
+static uint8_t menuItemsCount = 0;
 
 static void (**updateCallbacks)() = NULL;
 static uint32_t updateCallbacksCount = 0;
@@ -91,7 +72,7 @@ static switchState_t GetSwitchState();
  * @param [in] dialValue
  * @return menu item number, is valid only when switch state == SWITCH_MENU_ITEM
  */
-static settingsVariable_t GetSelectedMenuItem(float dialValue);
+static uint8_t GetSelectedMenuItem(float dialValue);
 
 /**@brief checks if dial is for ITEM_SELECTION_COUNTER_MAX samples on one value
  *        then assumes item to be selected
@@ -101,7 +82,7 @@ static settingsVariable_t GetSelectedMenuItem(float dialValue);
  * @param [out] currentSelectedVariable - changed when item is selected
  * @return true if new item was selected
  */
-static bool DetectItemSelection(switchState_t switchState, float dialValue, settingsVariable_t *currentSelectedVariable);
+static bool DetectItemSelection(switchState_t switchState, float dialValue, uint8_t *currentSelectedVariable);
 
 /**@brief check if switch moved from SWITCH_MENU_ITEM_VALUE to SWITCH_MENU_ITEM_VALUE
  *        and stayed there for VALUE_READOUT_COUNTER_MAX cycles
@@ -145,7 +126,7 @@ static void PlayUint(uint32_t integer, uint8_t minDigits);
  *        short beep = 1
  * @param [in] number
  */
-static void PlayNumber(settingsVariable_t number);
+static void PlayNumber(uint8_t number);
 
 /*****************************************************************************
                            INTERFACE IMPLEMENTATION
@@ -153,28 +134,23 @@ static void PlayNumber(settingsVariable_t number);
 
 bool RemoteSettingsInit()
 {
-    if(!EepromRead(EEPROM_PID_XY_P, &variables[RS_PID_XY_P])){variables[RS_PID_XY_P] = variablesDefaultValues[RS_PID_XY_P];}
-    if(!EepromRead(EEPROM_PID_XY_I, &variables[RS_PID_XY_I])){variables[RS_PID_XY_I] = variablesDefaultValues[RS_PID_XY_I];}
-    if(!EepromRead(EEPROM_PID_XY_D, &variables[RS_PID_XY_D])){variables[RS_PID_XY_D] = variablesDefaultValues[RS_PID_XY_D];}
-    if(!EepromRead(EEPROM_PID_Z_P , &variables[RS_PID_Z_P ])){variables[RS_PID_Z_P ] = variablesDefaultValues[RS_PID_Z_P ];}
-    if(!EepromRead(EEPROM_PID_Z_I , &variables[RS_PID_Z_I ])){variables[RS_PID_Z_I ] = variablesDefaultValues[RS_PID_Z_I ];}
-    if(!EepromRead(EEPROM_PID_Z_D , &variables[RS_PID_Z_D ])){variables[RS_PID_Z_D ] = variablesDefaultValues[RS_PID_Z_D ];}
-    if(!EepromRead(EEPROM_PID_N   , &variables[RS_PID_N   ])){variables[RS_PID_N   ] = variablesDefaultValues[RS_PID_N   ];}
-
-    if(!MemoryRegisterVariable(EEPROM_PID_XY_P, &variables[RS_PID_XY_P])){return false;}
-    if(!MemoryRegisterVariable(EEPROM_PID_XY_I, &variables[RS_PID_XY_I])){return false;}
-    if(!MemoryRegisterVariable(EEPROM_PID_XY_D, &variables[RS_PID_XY_D])){return false;}
-    if(!MemoryRegisterVariable(EEPROM_PID_Z_P , &variables[RS_PID_Z_P ])){return false;}
-    if(!MemoryRegisterVariable(EEPROM_PID_Z_I , &variables[RS_PID_Z_I ])){return false;}
-    if(!MemoryRegisterVariable(EEPROM_PID_Z_D , &variables[RS_PID_Z_D ])){return false;}
-    if(!MemoryRegisterVariable(EEPROM_PID_N   , &variables[RS_PID_N   ])){return false;}
+    menuItemsCount = 0;
 
-    return true;
+    for(parameterId_t id=0; id<PARAMETERS_COUNT; id++)
+    {
+        if(ParametersGetDescriptor(id)->scale != 0.0f)
+        {
+            menuItems[menuItemsCount] = id;
+            menuItemsCount++;
+        }
+    }
+
+    return menuItemsCount > 0;
 }
 
 void RemoteSettingsTask()
 {
-    settingsVariable_t currentSelectedVariable = 0;
+    uint8_t currentSelectedVariable = 0;
 
     float valueChangeStartingPoint = 0.0f;
     float valueChangeDialReference = 0.5f;
@@ -199,29 +175,30 @@ void RemoteSettingsTask()
             osDelay(200);
             SoundNotificationsPlay(SN_SETTINGS_MENU_ITEM_1);
             valueChangeDialReference = RadioStatusGetChannelData(RADIO_DIAL_CHANNEL);
-            valueChangeStartingPoint = variables[currentSelectedVariable];
+            ParametersGet(menuItems[currentSelectedVariable], &valueChangeStartingPoint);
             valueChangeStartingPointReady = true;
         }
 
         if(switchState == SWITCH_MENU_ITEM_VALUE && valueChangeStartingPointReady)
         {
-            variables[currentSelectedVariable] = valueChangeStartingPoint-VALUE_CHANGE_SCALE*variablesMultipliers[currentSelectedVariable]*(dialValue-valueChangeDialReference);
+            parameterId_t id = menuItems[currentSelectedVariable];
+            float scale = ParametersGetDescriptor(id)->scale;
+            ParametersSet(id, valueChangeStartingPoint-VALUE_CHANGE_SCALE*scale*(dialValue-valueChangeDialReference));
         } else {
             valueChangeStartingPointReady = false;
         }
 
         if(DetectValueReadout(switchState, dialValue))
         {
-            PlayFloat(variables[currentSelectedVariable]);
+            float value = 0.0f;
+            ParametersGet(menuItems[currentSelectedVariable], &value);
+            PlayFloat(value);
             osDelay(2000);
         }
 
         if(DetectValueUpdate(switchState))
         {
-            for(uint8_t i=0; i<updateCallbacksCount; i++)
-            {
-                updateCallbacks[i]();
-            }
+            RemoteSettingsNotifyUpdate();
         }
 
         do{
@@ -243,36 +220,27 @@ bool RemoteSettingsAddUpdateCallback(void (*updateCallback)(void))
     {
         ptr = malloc(sizeof(*updateCallbacks));
     } else {
-        ptr = realloc(updateCallbacks,sizeof(*updateCallbacks));
+        ptr = realloc(updateCallbacks,(updateCallbacksCount+1)*sizeof(*updateCallbacks));
     }
 
-    updateCallbacks = ptr!=NULL ? ptr : updateCallbacks;
-    updateCallbacks[updateCallbacksCount] = updateCallback;
-    updateCallbacksCount++;
-
-    return true;
-}
-
-bool RemoteSettingsSetVariable(settingsVariable_t variable, float value)
-{
-    if(variable >= RS_VARIABLES_COUNT)
+    if(ptr == NULL)
     {
         return false;
     }
-    variables[variable] = value;
+
+    updateCallbacks = ptr;
+    updateCallbacks[updateCallbacksCount] = updateCallback;
+    updateCallbacksCount++;
 
     return true;
 }
 
-bool RemoteSettingsGetVariable(settingsVariable_t variable, float *value)
+void RemoteSettingsNotifyUpdate()
 {
-    if(variable >= RS_VARIABLES_COUNT)
+    for(uint8_t i=0; i<updateCallbacksCount; i++)
     {
-        return false;
+        updateCallbacks[i]();
     }
-    *value = variables[variable];
-
-    return true;
 }
 
 /******************************************************************************
@@ -296,18 +264,18 @@ static switchState_t GetSwitchState()
     return SWITCH_MENU_ITEM;
 }
 
-static settingsVariable_t GetSelectedMenuItem(float dialValue)
+static uint8_t GetSelectedMenuItem(float dialValue)
 {
-    float step = 1/(float)RS_VARIABLES_COUNT;
-    settingsVariable_t selectedVariable = (settingsVariable_t)(dialValue/step);
+    float step = 1/(float)menuItemsCount;
+    uint8_t selectedVariable = dialValue > 0.0f ? (uint8_t)(dialValue/step) : 0;
 
-    return selectedVariable >= RS_VARIABLES_COUNT ? RS_VARIABLES_COUNT-1 : selectedVariable;
+    return selectedVariable >= menuItemsCount ? menuItemsCount-1 : selectedVariable;
 }
 
 
-static bool DetectItemSelection(switchState_t switchState, float dialValue, settingsVariable_t *currentSelectedVariable)
+static bool DetectItemSelection(switchState_t switchState, float dialValue, uint8_t *currentSelectedVariable)
 {
-    static settingsVariable_t lastVariable = 0;
+    static uint8_t lastVariable = 0;
     static uint8_t itemSelectionCounter = 0;
 
     if(switchState != SWITCH_MENU_ITEM)
@@ -317,7 +285,7 @@ static bool DetectItemSelection(switchState_t switchState, float dialValue, sett
         return false;
     }
 
-    settingsVariable_t currentVariable = GetSelectedMenuItem(dialValue);
+    uint8_t currentVariable = GetSelectedMenuItem(dialValue);
 
     if(itemSelectionCounter == ITEM_SELECTION_COUNTER_MAX)
     {
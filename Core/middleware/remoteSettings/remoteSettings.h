@@ -15,29 +15,14 @@
                        PUBLIC DEFINES / MACROS / ENUMS
 *****************************************************************************/
 
-/**@warning when adding new settings variable, it is required to update:
- *  - eeprom saving mechanism in RemoteSettingsInit
- *  - variablesDefaultValues
- *  - variablesMultipliers
- */
-typedef enum{
-    RS_CALIBRATION = 0,/**< RS_CALIBRATION */
-    RS_PID_XY_P,       /**< RS_PID_XY_P */
-    RS_PID_XY_I,       /**< RS_PID_XY_I */
-    RS_PID_XY_D,       /**< RS_PID_XY_D */
-    RS_PID_Z_P,        /**< RS_PID_Z_P */
-    RS_PID_Z_I,        /**< RS_PID_Z_I */
-    RS_PID_Z_D,        /**< RS_PID_Z_D */
-    RS_PID_N,          /**< RS_PID_N */
-
-    RS_VARIABLES_COUNT /**< RS_VARIABLES_COUNT */
-}settingsVariable_t;
+/** menu items are parameters with nonzero scale, see middleware/parameters/parameterTable.h **/
 
 /*****************************************************************************
                          PUBLIC INTERFACE DECLARATION
 *****************************************************************************/
 
-/**@brief registers settings variables in memory
+/**@brief builds menu from parameters that can be changed from radio,
+ *        call after ParametersInit
  *
  * @return true if successful
  */
@@ -55,18 +40,6 @@ void RemoteSettingsTask();
  */
 bool RemoteSettingsAddUpdateCallback(void (*updateCallback)(void));
 
-/**@brief sets settings variable
- *
- * @param [in] variable
- * @param [in] value
- * @return true if successful
- */
-bool RemoteSettingsSetVariable(settingsVariable_t variable, float value);
-
-/**@brief getter for settings variable
- *
- * @param [in] variable
- * @param [out] value
- * @return true if successful
+/**@brief calls all update callbacks, used when parameters were changed outside of menu
  */
-bool RemoteSettingsGetVariable(settingsVariable_t variable, float *value);
+void RemoteSettingsNotifyUpdate();
@@ -0,0 +1,168 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/rpmFilter/rpmFilter.c
+ *
+ * @brief Source code
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/rpmFilter/rpmFilter.h"
+
+#include <string.h>
+#include <math.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define RPM_FILTER_NOTCHES (MOTORS_COUNT*RPM_FILTER_HARMONICS)
+#define RPM_FILTER_MAX_FREQUENCY_RATIO (0.48f)  ///< max notch frequency / sample frequency
+#define RPM_FILTER_PI (3.14159265f)
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+/**@brief biquad coefficients normalized to a0 **/
+typedef struct{
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+}notchCoefficients_t;
+
+/**@brief transposed direct form II state of single axis **/
+typedef struct{
+    float s1;
+    float s2;
+}notchState_t;
+
+static float sampleTime = 0;
+
+static notchCoefficients_t coefficients[RPM_FILTER_NOTCHES];
+static notchState_t states[RPM_FILTER_NOTCHES][3];
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief calculates notch coefficients, notch passes signal if frequency is 0
+ *
+ * @param [in] frequency - [Hz]
+ * @param [out] notch
+ */
+static void SetNotch(float frequency, notchCoefficients_t* notch);
+
+/**@brief filters single sample
+ *
+ * @param [in] notch
+ * @param [in] state
+ * @param [in] input
+ * @return filtered sample
+ */
+static inline float ProcessNotch(const notchCoefficients_t* notch, notchState_t* state, float input);
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+bool RpmFilterInit(float sampleFrequency)
+{
+    if(sampleFrequency <= 0)
+    {
+        return false;
+    }
+
+    sampleTime = 1.0f/sampleFrequency;
+
+    memset(states, 0, sizeof(states));
+    for(uint8_t notch=0; notch<RPM_FILTER_NOTCHES; notch++)
+    {
+        SetNotch(0, &coefficients[notch]);
+    }
+
+    return true;
+}
+
+void RpmFilterUpdate(const float rpm[MOTORS_COUNT], uint8_t validMask)
+{
+    if(rpm == NULL)
+    {
+        return;
+    }
+
+    float maxFrequency = RPM_FILTER_MAX_FREQUENCY_RATIO/sampleTime;
+
+    for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+    {
+        float rotorFrequency = rpm[motor]/60.0f;
+        if(!(validMask & (1U<<motor)))
+        {
+            rotorFrequency = 0;
+        } else if(rotorFrequency < RPM_FILTER_MIN_FREQUENCY)
+        {
+            rotorFrequency = RPM_FILTER_MIN_FREQUENCY;
+        }
+
+        for(uint8_t harmonic=0; harmonic<RPM_FILTER_HARMONICS; harmonic++)
+        {
+            float frequency = rotorFrequency*(float)(harmonic+1);
+            if(frequency > maxFrequency)
+            {
+                frequency = 0;
+            }
+
+            SetNotch(frequency, &coefficients[motor*RPM_FILTER_HARMONICS+harmonic]);
+        }
+    }
+}
+
+vector_t RpmFilterApply(vector_t gyro)
+{
+    for(uint8_t notch=0; notch<RPM_FILTER_NOTCHES; notch++)
+    {
+        gyro.x = ProcessNotch(&coefficients[notch], &states[notch][0], gyro.x);
+        gyro.y = ProcessNotch(&coefficients[notch], &states[notch][1], gyro.y);
+        gyro.z = ProcessNotch(&coefficients[notch], &states[notch][2], gyro.z);
+    }
+
+    return gyro;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static void SetNotch(float frequency, notchCoefficients_t* notch)
+{
+    if(frequency <= 0)
+    {
+        notch->b0 = 1;
+        notch->b1 = 0;
+        notch->b2 = 0;
+        notch->a1 = 0;
+        notch->a2 = 0;
+        return;
+    }
+
+    float omega = 2.0f*RPM_FILTER_PI*frequency*sampleTime;
+    float alpha = sinf(omega)/(2.0f*RPM_FILTER_Q);
+    float a0 = 1.0f+alpha;
+
+    notch->b0 = 1.0f/a0;
+    notch->b1 = -2.0f*cosf(omega)/a0;
+    notch->b2 = notch->b0;
+    notch->a1 = notch->b1;
+    notch->a2 = (1.0f-alpha)/a0;
+}
+
+static inline float ProcessNotch(const notchCoefficients_t* notch, notchState_t* state, float input)
+{
+    float output = notch->b0*input+state->s1;
+    state->s1 = notch->b1*input-notch->a1*output+state->s2;
+    state->s2 = notch->b2*input-notch->a2*output;
+
+    return output;
+}
@@ -0,0 +1,53 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/rpmFilter/rpmFilter.h
+ *
+ * @brief Header file
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "drivers/motors/motors.h"
+#include "middleware/vector/vector.h"
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define RPM_FILTER_HARMONICS (3U)           ///< notches per motor at 1x, 2x, 3x rotor frequency
+#define RPM_FILTER_MIN_FREQUENCY (80.0f)    ///< [Hz] notch never goes bellow this frequency
+#define RPM_FILTER_Q (5.0f)                 ///< notch quality, center frequency / bandwidth
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief resets notch bank, all notches pass signal until first update
+ *
+ * @param [in] sampleFrequency - [Hz] gyro sample frequency
+ * @return true if successful
+ */
+bool RpmFilterInit(float sampleFrequency);
+
+/**@brief moves notches to harmonics of motor rotor frequencies,
+ *        notches of motors without valid rpm and harmonics above 0.48 of sample frequency pass signal
+ *
+ * @note with 1kHz mahony tick notches reach only 480Hz, all 3 harmonics are filtered up to 9600rpm (160Hz),
+ *       above it 3-rd harmonic passes, above 14400rpm (240Hz) only 1-st harmonic is filtered,
+ *       bellow 4800rpm notches stay at RPM_FILTER_MIN_FREQUENCY harmonics
+ *
+ * @param [in] rpm - [rev/min] MOTORS_COUNT values indexed by motors_t
+ * @param [in] validMask - bit per motor, set if rpm of that motor is valid
+ */
+void RpmFilterUpdate(const float rpm[MOTORS_COUNT], uint8_t validMask);
+
+/**@brief filters gyro sample by all notches, call once per gyro sample
+ *
+ * @param [in] gyro - [rad/s]
+ * @return filtered gyro
+ */
+vector_t RpmFilterApply(vector_t gyro);
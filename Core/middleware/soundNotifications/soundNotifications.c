@@ -112,9 +112,21 @@ static const soundData_t notifications[] = {
         .samples = {{1300  , 400}}
 
     },
+    {                           ///< SN_MOTOR_FAILURE
+        .size = 6,
+        .samples = {{2500  , 100},
+                    {40000 , 50},
+                    {2500  , 100},
+                    {40000 , 50},
+                    {2500  , 100},
+                    {40000 , 50}}
+
+    },
 };
 
 QueueHandle_t soundQueueHandle = NULL; ///< holds currently playing notification
+static StaticQueue_t soundQueueBuffer;
+static uint8_t soundQueueStorage[NOTIFICATION_SIZE*sizeof(soundSample_t)];
 
 /*****************************************************************************
                          PRIVATE FUNCTION DECLARATION
@@ -126,10 +138,20 @@ QueueHandle_t soundQueueHandle = NULL; ///< holds currently playing notification
                            INTERFACE IMPLEMENTATION
 *****************************************************************************/
 
-void SoundNotificationTask()
+bool SoundNotificationsInit()
 {
-    soundQueueHandle = xQueueCreate(NOTIFICATION_SIZE,sizeof( soundSample_t ) );
+    soundQueueHandle = xQueueCreateStatic(NOTIFICATION_SIZE, sizeof(soundSample_t), soundQueueStorage, &soundQueueBuffer);
 
+    return soundQueueHandle != NULL;
+}
+
+uint32_t SoundNotificationsGetStaticRamSize()
+{
+    return sizeof(soundQueueBuffer)+sizeof(soundQueueStorage);
+}
+
+void SoundNotificationTask()
+{
     while(1)
     {
         soundSample_t currentSample;
@@ -31,6 +31,8 @@ typedef enum{
 
     SN_SETTINGS_MENU_ITEM_1,
     SN_SETTINGS_MENU_ITEM_5,
+
+    SN_MOTOR_FAILURE,
 }SoundNotifications_t;
 
 typedef enum{
@@ -52,6 +54,19 @@ typedef enum{
                          PUBLIC INTERFACE DECLARATION
 *****************************************************************************/
 
+/**@brief creates statically allocated notification queue,
+ *        call before any notification is played in non blocking mode
+ *
+ * @return true if successful
+ */
+bool SoundNotificationsInit();
+
+/**@brief RAM reserved for notification queue
+ *
+ * @return size in bytes
+ */
+uint32_t SoundNotificationsGetStaticRamSize();
+
 /**@brief sound notification freertos task
  *        used to play notifications in non blocking mode
  */
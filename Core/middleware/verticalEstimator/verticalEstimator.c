@@ -0,0 +1,128 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/verticalEstimator/verticalEstimator.c
+ *
+ * @brief Source code
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/verticalEstimator/verticalEstimator.h"
+
+#include <stddef.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+/** third order complementary filter gains, all poles at -1/time constant **/
+#define GAIN_ALTITUDE (3.0f/VERTICAL_ESTIMATOR_TIME_CONSTANT)
+#define GAIN_CLIMB_RATE (3.0f/(VERTICAL_ESTIMATOR_TIME_CONSTANT*VERTICAL_ESTIMATOR_TIME_CONSTANT))
+#define GAIN_BIAS (1.0f/(VERTICAL_ESTIMATOR_TIME_CONSTANT*VERTICAL_ESTIMATOR_TIME_CONSTANT*VERTICAL_ESTIMATOR_TIME_CONSTANT))
+
+#define MAX_CORRECTION_DT (0.2f)    ///< [s] longer baro gaps are not integrated at once
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+typedef struct{
+    uint32_t step;      ///< timestamp/VERTICAL_ESTIMATOR_HISTORY_STEP_MS
+    float altitude;     ///< [m]
+}historyEntry_t;
+
+static verticalState_t currentState = {.altitude = 0, .climbRate = 0, .accBias = 0};
+
+static historyEntry_t history[VERTICAL_ESTIMATOR_HISTORY_SIZE];
+static uint32_t lastHistoryStep = 0;
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief finds estimated altitude at given time
+ *
+ * @param [in] timestamp - [ms]
+ * @return altitude from history or current altitude if timestamp is not covered
+ */
+static float GetDelayedAltitude(uint32_t timestamp);
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+void VerticalEstimatorReset(float altitude)
+{
+    currentState.altitude = altitude;
+    currentState.climbRate = 0;
+
+    for(uint32_t i=0; i<VERTICAL_ESTIMATOR_HISTORY_SIZE; i++)
+    {
+        history[i].step = UINT32_MAX;
+        history[i].altitude = altitude;
+    }
+}
+
+void VerticalEstimatorPredict(float acceleration, float dt, uint32_t timestamp)
+{
+    float acc = acceleration-currentState.accBias;
+
+    currentState.altitude += currentState.climbRate*dt + 0.5f*acc*dt*dt;
+    currentState.climbRate += acc*dt;
+
+    uint32_t step = timestamp/VERTICAL_ESTIMATOR_HISTORY_STEP_MS;
+    if(step != lastHistoryStep)
+    {
+        lastHistoryStep = step;
+        history[step%VERTICAL_ESTIMATOR_HISTORY_SIZE].step = step;
+        history[step%VERTICAL_ESTIMATOR_HISTORY_SIZE].altitude = currentState.altitude;
+    }
+}
+
+void VerticalEstimatorCorrect(float altitude, float dt, uint32_t timestamp)
+{
+    if(dt > MAX_CORRECTION_DT)
+    {
+        dt = MAX_CORRECTION_DT;
+    }
+
+    float error = altitude-GetDelayedAltitude(timestamp);
+    float altitudeCorrection = GAIN_ALTITUDE*error*dt;
+
+    currentState.altitude += altitudeCorrection;
+    currentState.climbRate += GAIN_CLIMB_RATE*error*dt;
+    currentState.accBias -= GAIN_BIAS*error*dt;
+
+    /** keep history consistent so next delayed sample does not see the same error again **/
+    for(uint32_t i=0; i<VERTICAL_ESTIMATOR_HISTORY_SIZE; i++)
+    {
+        history[i].altitude += altitudeCorrection;
+    }
+}
+
+bool VerticalEstimatorGetState(verticalState_t* state)
+{
+    if(state == NULL)
+    {
+        return false;
+    }
+
+    *state = currentState;
+    return true;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static float GetDelayedAltitude(uint32_t timestamp)
+{
+    uint32_t step = timestamp/VERTICAL_ESTIMATOR_HISTORY_STEP_MS;
+    const historyEntry_t* entry = &history[step%VERTICAL_ESTIMATOR_HISTORY_SIZE];
+
+    if(entry->step != step)
+    {
+        return currentState.altitude;
+    }
+    return entry->altitude;
+}
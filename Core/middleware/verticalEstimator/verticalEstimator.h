@@ -0,0 +1,61 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Core/middleware/verticalEstimator/verticalEstimator.h
+ *
+ * @brief Header file
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define VERTICAL_ESTIMATOR_TIME_CONSTANT (1.5f)     ///< [s] baro to accelerometer crossover
+#define VERTICAL_ESTIMATOR_HISTORY_STEP_MS (10U)    ///< [ms] resolution of altitude history for delayed baro samples
+#define VERTICAL_ESTIMATOR_HISTORY_SIZE (32U)       ///< history length, covers 320ms of baro latency
+
+/**@brief vertical state estimate, up is positive **/
+typedef struct{
+    float altitude;     ///< [m]
+    float climbRate;    ///< [m/s]
+    float accBias;      ///< [m/s^2] accelerometer bias along vertical axis
+}verticalState_t;
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief resets estimator to given altitude at rest, bias is kept
+ *
+ * @param [in] altitude - [m]
+ */
+void VerticalEstimatorReset(float altitude);
+
+/**@brief propagates state with vertical acceleration, third order complementary filter
+ *
+ * @param [in] acceleration - [m/s^2] earth frame vertical acceleration without gravity
+ * @param [in] dt - [s] time since last prediction
+ * @param [in] timestamp - [ms] time of acceleration sample
+ */
+void VerticalEstimatorPredict(float acceleration, float dt, uint32_t timestamp);
+
+/**@brief corrects state with baro altitude, innovation is calculated against
+ *        estimated altitude at time of baro sample so FIFO latency does not add lag
+ *
+ * @param [in] altitude - [m] baro altitude
+ * @param [in] dt - [s] time since last correction
+ * @param [in] timestamp - [ms] time at which baro sample was converted
+ */
+void VerticalEstimatorCorrect(float altitude, float dt, uint32_t timestamp);
+
+/**@brief getter for latest state
+ *
+ * @param [out] state
+ * @return true if successful
+ */
+bool VerticalEstimatorGetState(verticalState_t* state);
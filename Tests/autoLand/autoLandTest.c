@@ -0,0 +1,178 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Tests/autoLand/autoLandTest.c
+ *
+ * @brief Host test of loss-of-signal landing, autoLand and altitudeHold
+ *        against vertical plant model
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/autoLand/autoLand.h"
+#include "middleware/altitudeHold/altitudeHold.h"
+#include "plant/verticalPlant.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define LOOP_PERIOD (0.02f)         ///< [s] FLIGHT_CONTROLLER_MAX_PERIOD_MS, no radio frames wake flight controller in homing
+#define MAX_LANDING_TIME (60.0f)    ///< [s]
+#define MAX_TOUCHDOWN_SPEED (1.5f)  ///< [m/s]
+#define IDLE_THROTTLE (0.05f)       ///< DEVICE_MANAGER_THROTTLE_OFF_TRH, flight controller drops attitude control bellow it
+
+#define CHECK(condition) \
+    do{ \
+        if(!(condition)) \
+        { \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            return false; \
+        } \
+    }while(0)
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief runs landing until AUTO_LAND_LANDED or timeout
+ *
+ * @param [in/out] plant
+ * @param [in] estimateValid - false simulates uncalibrated baro
+ * @param [out] maxThrottle - highest commanded throttle
+ * @return landing time [s], MAX_LANDING_TIME on timeout
+ */
+static float RunLanding(verticalPlant_t* plant, bool estimateValid, float* maxThrottle);
+
+static bool TestLandingFromHover();
+static bool TestOpenLoopLanding();
+static bool TestFailsafeOnGround();
+static bool TestAltitudeHoldAboveIdle();
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+int main()
+{
+    struct{
+        const char* name;
+        bool (*test)();
+    }tests[] = {
+        {"failsafe on ground keeps motors off", &TestFailsafeOnGround},
+        {"landing from hover", &TestLandingFromHover},
+        {"open loop landing without baro", &TestOpenLoopLanding},
+        {"altitude hold stays above idle", &TestAltitudeHoldAboveIdle},
+    };
+
+    int failed = 0;
+    for(unsigned i=0; i<sizeof(tests)/sizeof(tests[0]); i++)
+    {
+        bool passed = tests[i].test();
+        printf("%s %s\n", passed ? "PASS" : "FAIL", tests[i].name);
+        failed += passed ? 0 : 1;
+    }
+
+    return failed;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static float RunLanding(verticalPlant_t* plant, bool estimateValid, float* maxThrottle)
+{
+    *maxThrottle = 0;
+
+    float time;
+    for(time=0; time<MAX_LANDING_TIME && AutoLandGetPhase() != AUTO_LAND_LANDED; time+=LOOP_PERIOD)
+    {
+        autoLandInput_t input = {.altitude = plant->altitude,
+                                 .climbRate = plant->climbRate,
+                                 .peakAcceleration = plant->peakAcceleration,
+                                 .attitudeError = 0,
+                                 .estimateValid = estimateValid};
+
+        float throttle = AutoLandUpdate(&input, LOOP_PERIOD);
+        *maxThrottle = throttle > *maxThrottle ? throttle : *maxThrottle;
+
+        VerticalPlantStep(plant, throttle, LOOP_PERIOD);
+    }
+
+    return time;
+}
+
+static bool TestFailsafeOnGround()
+{
+    verticalPlant_t plant = {.onGround = true};
+
+    AutoLandStart(0, 0, false);
+    CHECK(AutoLandGetPhase() == AUTO_LAND_LANDED);
+
+    for(int i=0; i<100; i++)
+    {
+        autoLandInput_t input = {.estimateValid = true};
+        CHECK(AutoLandUpdate(&input, LOOP_PERIOD) == 0);
+        VerticalPlantStep(&plant, 0, LOOP_PERIOD);
+    }
+    CHECK(plant.altitude == 0);
+
+    return true;
+}
+
+static bool TestLandingFromHover()
+{
+    verticalPlant_t plant = {.altitude = 10.0f};
+
+    AutoLandStart(plant.altitude, PLANT_HOVER_THROTTLE, true);
+    CHECK(AutoLandGetPhase() == AUTO_LAND_LEVEL);
+
+    float maxThrottle;
+    float time = RunLanding(&plant, true, &maxThrottle);
+
+    printf("  landed after %.1fs, touchdown %.2fm/s\n", time, plant.touchdownSpeed);
+    CHECK(time < MAX_LANDING_TIME);
+    CHECK(plant.onGround && plant.altitude == 0);
+    CHECK(plant.touchdownSpeed < MAX_TOUCHDOWN_SPEED);
+    /** descent at AUTO_LAND_DESCENT_RATE takes ~14s from 10m **/
+    CHECK(time > 10.0f/AUTO_LAND_DESCENT_RATE*0.7f);
+
+    return true;
+}
+
+static bool TestOpenLoopLanding()
+{
+    verticalPlant_t plant = {.altitude = 5.0f};
+
+    AutoLandStart(plant.altitude, PLANT_HOVER_THROTTLE, true);
+
+    float maxThrottle;
+    float time = RunLanding(&plant, false, &maxThrottle);
+
+    printf("  landed after %.1fs, touchdown %.2fm/s\n", time, plant.touchdownSpeed);
+    CHECK(time < MAX_LANDING_TIME);
+    CHECK(plant.onGround);
+    CHECK(plant.touchdownSpeed < MAX_TOUCHDOWN_SPEED);
+    CHECK(maxThrottle <= PLANT_HOVER_THROTTLE);
+
+    return true;
+}
+
+static bool TestAltitudeHoldAboveIdle()
+{
+    AltitudeHoldReset(10.0f, PLANT_HOVER_THROTTLE);
+
+    /** full down stick while still climbing fast asks for throttle far bellow hover **/
+    float climbRate = AltitudeHoldStickToClimbRate(0);
+    for(int i=0; i<100; i++)
+    {
+        float throttle = AltitudeHoldUpdate(climbRate, 10.0f, ALTITUDE_HOLD_MAX_CLIMB_RATE, LOOP_PERIOD);
+        CHECK(throttle >= ALTITUDE_HOLD_MIN_THROTTLE);
+        CHECK(throttle > IDLE_THROTTLE);
+    }
+
+    return true;
+}
@@ -0,0 +1,380 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Tests/deviceManager/deviceManagerTest.c
+ *
+ * @brief Host test of loss-of-signal scenario end to end,
+ *        device manager transition table drives autoLand against vertical plant model,
+ *        FreeRTOS and drivers are replaced by fakes bellow
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "app/deviceManager/deviceManager.h"
+
+#include "cmsis_os.h"
+#include "event_groups.h"
+
+#include "drivers/BMX055/BMX055.h"
+#include "drivers/LPS/LPS.h"
+#include "drivers/uart/uart.h"
+#include "drivers/utils/utils.h"
+#include "drivers/radio/radio.h"
+#include "drivers/adc/adc.h"
+#include "drivers/buzzer/buzzer.h"
+#include "drivers/eeprom/eeprom.h"
+#include "drivers/motors/motors.h"
+
+#include "middleware/batteryStatus/batteryStatus.h"
+#include "middleware/mahonyFilter/mahonyFilter.h"
+#include "middleware/soundNotifications/soundNotifications.h"
+#include "middleware/radioStatus/radioStatus.h"
+#include "middleware/remoteSettings/remoteSettings.h"
+#include "middleware/memory/memory.h"
+#include "middleware/parameters/parameters.h"
+#include "middleware/configProtocol/configProtocol.h"
+#include "middleware/flightController/flightController.h"
+#include "middleware/altitude/altitude.h"
+#include "middleware/motorTelemetry/motorTelemetry.h"
+#include "middleware/imuCalibration/imuCalibration.h"
+#include "middleware/autoLand/autoLand.h"
+#include "plant/verticalPlant.h"
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define LOOP_PERIOD_MS (20U)            ///< FLIGHT_CONTROLLER_MAX_PERIOD_MS, loop period in homing
+#define ARM_TIME_MS (1000U)             ///< pilot raises throttle
+#define SIGNAL_LOSS_TIME_MS (3000U)     ///< receiver stops sending frames
+#define MAX_SCENARIO_TIME_MS (120000U)
+#define HOVER_ALTITUDE (10.0f)          ///< [m] altitude at signal loss
+#define MAX_TOUCHDOWN_SPEED (1.5f)      ///< [m/s]
+
+#define CHECK(condition) \
+    do{ \
+        if(!(condition)) \
+        { \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            return false; \
+        } \
+    }while(0)
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+/** parameter values, normally defined by parameters module **/
+parametersValues_t parametersValues;
+
+static jmp_buf scenarioEnd;
+static bool scenarioTimeout = false;
+
+static TickType_t tick = 0;
+static uint32_t pendingEvents = 0;
+static TaskFunction_t deviceManagerTask = NULL;
+static bool flightControllerResumed = false;
+
+/** world state seen through faked modules **/
+static struct{
+    bool radioConnected;
+    float throttleStick;
+    float motorsPower[MOTORS_COUNT];
+    uint32_t motorsStopped;     ///< MotorsSetAll calls, only device manager stops motors directly
+    bool eraseBlocked;
+    verticalPlant_t plant;
+    bool autoLandActive;
+    bool landedPosted;
+    bool homingVisited;
+    float lastThrottle;
+}world;
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief one flight controller iteration and pilot / receiver actions of scenario
+ */
+static void WorldStep();
+
+static bool TestSignalLossLandsAndDisarms();
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+int main()
+{
+    struct{
+        const char* name;
+        bool (*test)();
+    }tests[] = {
+        {"signal loss in flight lands and disarms", &TestSignalLossLandsAndDisarms},
+    };
+
+    int failed = 0;
+    for(unsigned i=0; i<sizeof(tests)/sizeof(tests[0]); i++)
+    {
+        bool passed = tests[i].test();
+        printf("%s %s\n", passed ? "PASS" : "FAIL", tests[i].name);
+        failed += passed ? 0 : 1;
+    }
+
+    return failed;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static void WorldStep()
+{
+    deviceOperatingModes_t mode = DeviceManagerGetOperatingMode();
+
+    if(tick == ARM_TIME_MS)
+    {
+        world.throttleStick = 0.5f;
+        DeviceManagerPostEvent(DM_EVENT_THROTTLE_HIGH);
+    }
+
+    if(mode == DEVICE_FLIGHT)
+    {
+        /** pilot took off and hovers, stick is in the middle **/
+        if(world.plant.altitude == 0)
+        {
+            world.plant.altitude = HOVER_ALTITUDE;
+        }
+        world.lastThrottle = world.throttleStick;
+        for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+        {
+            world.motorsPower[motor] = PLANT_HOVER_THROTTLE;
+        }
+        VerticalPlantStep(&world.plant, PLANT_HOVER_THROTTLE, LOOP_PERIOD_MS*0.001f);
+    }
+
+    if(tick == SIGNAL_LOSS_TIME_MS)
+    {
+        world.radioConnected = false;
+        DeviceManagerPostEvent(DM_EVENT_RADIO_LOST);
+    }
+
+    /** the same sequence as landing part of flight controller loop **/
+    if(mode == DEVICE_HOMING)
+    {
+        world.homingVisited = true;
+
+        autoLandInput_t input = {.altitude = world.plant.altitude,
+                                 .climbRate = world.plant.climbRate,
+                                 .peakAcceleration = world.plant.peakAcceleration,
+                                 .attitudeError = 0,
+                                 .estimateValid = true};
+
+        if(!world.autoLandActive)
+        {
+            AutoLandStart(input.altitude, PARAMETERS_GET(HOVER_THROTTLE), world.lastThrottle > DEVICE_MANAGER_THROTTLE_OFF_TRH);
+            world.autoLandActive = true;
+        }
+
+        float throttle = AutoLandUpdate(&input, LOOP_PERIOD_MS*0.001f);
+        VerticalPlantStep(&world.plant, throttle, LOOP_PERIOD_MS*0.001f);
+
+        if(AutoLandGetPhase() == AUTO_LAND_LANDED && !world.landedPosted)
+        {
+            DeviceManagerPostEvent(DM_EVENT_LANDED);
+            world.landedPosted = true;
+        }
+    }
+}
+
+static bool TestSignalLossLandsAndDisarms()
+{
+    static ADC_HandleTypeDef adc;
+    static SPI_HandleTypeDef spi;
+    static TIM_HandleTypeDef tim;
+    static UART_HandleTypeDef uart;
+
+    memset(&world, 0, sizeof(world));
+    world.radioConnected = true;
+    parametersValues.HOVER_THROTTLE = PLANT_HOVER_THROTTLE;
+
+    DeviceManagerInit(&adc, &spi, &spi, &tim, &uart, &tim);
+    CHECK(DeviceManagerGetOperatingMode() == DEVICE_STANDBY);
+    CHECK(deviceManagerTask != NULL);
+
+    /** device manager task never returns, scenario leaves it from event group wait **/
+    if(setjmp(scenarioEnd) == 0)
+    {
+        deviceManagerTask(NULL);
+    }
+
+    printf("  disarmed after %.1fs, touchdown %.2fm/s\n", tick*0.001f, world.plant.touchdownSpeed);
+    CHECK(!scenarioTimeout);
+    CHECK(flightControllerResumed);
+    CHECK(world.homingVisited);
+    CHECK(DeviceManagerGetOperatingMode() == DEVICE_STANDBY);
+    CHECK(world.plant.onGround);
+    CHECK(world.plant.touchdownSpeed < MAX_TOUCHDOWN_SPEED);
+    CHECK(world.motorsStopped == 1);
+    for(uint8_t motor=0; motor<MOTORS_COUNT; motor++)
+    {
+        CHECK(world.motorsPower[motor] == 0);
+    }
+    CHECK(!world.eraseBlocked);
+
+    return true;
+}
+
+/******************************************************************************
+                             FREERTOS FAKES
+******************************************************************************/
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode, const char* const pcName, const uint32_t ulStackDepth,
+                               void* const pvParameters, UBaseType_t uxPriority, StackType_t* const puxStackBuffer,
+                               StaticTask_t* const pxTaskBuffer)
+{
+    (void)ulStackDepth;
+    (void)pvParameters;
+    (void)uxPriority;
+    (void)puxStackBuffer;
+
+    if(strcmp(pcName, "deviceManagerTask") == 0)
+    {
+        deviceManagerTask = pxTaskCode;
+    }
+
+    return (TaskHandle_t)pxTaskBuffer;
+}
+
+void vTaskResume(TaskHandle_t xTaskToResume)
+{
+    (void)xTaskToResume;
+    flightControllerResumed = true;
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return tick;
+}
+
+size_t xPortGetFreeHeapSize()
+{
+    return 0;
+}
+
+EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t* pxEventGroupBuffer)
+{
+    return (EventGroupHandle_t)pxEventGroupBuffer;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet)
+{
+    (void)xEventGroup;
+    pendingEvents |= uxBitsToSet;
+
+    return pendingEvents;
+}
+
+/** time passes only while device manager waits, world runs in flight controller periods until an event wakes it **/
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor,
+                                const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait)
+{
+    (void)xEventGroup;
+    (void)xClearOnExit;
+    (void)xWaitForAllBits;
+
+    if(world.landedPosted && DeviceManagerGetOperatingMode() == DEVICE_STANDBY)
+    {
+        longjmp(scenarioEnd, 1);
+    }
+
+    for(TickType_t waited=0; waited<xTicksToWait && pendingEvents == 0; waited+=LOOP_PERIOD_MS)
+    {
+        tick += LOOP_PERIOD_MS;
+        WorldStep();
+    }
+
+    if(tick >= MAX_SCENARIO_TIME_MS)
+    {
+        scenarioTimeout = true;
+        longjmp(scenarioEnd, 1);
+    }
+
+    EventBits_t events = pendingEvents&uxBitsToWaitFor;
+    pendingEvents = 0;
+
+    return events;
+}
+
+/******************************************************************************
+                        DRIVER AND MIDDLEWARE FAKES
+******************************************************************************/
+
+void UtilsInit(){}
+bool BuzzerInit(TIM_HandleTypeDef* timerHandle, uint32_t timerChannel){(void)timerHandle; (void)timerChannel; return true;}
+bool UartInit(UART_HandleTypeDef *uh){(void)uh; return true;}
+bool EepromInit(){return true;}
+void MemoryInit(){}
+bool ParametersInit(){return true;}
+bool Bmx055Init(SPI_HandleTypeDef *HSPI){(void)HSPI; return true;}
+bool LPSInit(SPI_HandleTypeDef *HSPI){(void)HSPI; return true;}
+bool AdcInit(ADC_HandleTypeDef* hadc){(void)hadc; return true;}
+bool RadioInit(){return true;}
+bool AltitudeInit(){return true;}
+bool MahonyFilterInit(){return true;}
+bool RemoteSettingsInit(){return true;}
+bool MotorsInit(TIM_HandleTypeDef* hTim, motorsProtocol_t protocol){(void)hTim; (void)protocol; return true;}
+bool FlightControllerInit(){return true;}
+bool SoundNotificationsInit(){return true;}
+uint32_t SoundNotificationsGetStaticRamSize(){return 0;}
+
+void SoundNotificationTask(){}
+void RadioStatusTask(){}
+void RemoteSettingsTask(){}
+void BatteryStatusTask(){}
+void MahonyFilterTask(){}
+void AltitudeTask(){}
+void ImuCalibrationTask(){}
+void FlightControllerTask(){}
+void MemoryTask(){}
+void ConfigProtocolTask(){}
+
+bool UartWrite(char *format, ...){(void)format; return true;}
+bool SoundNotificationsPlay(SoundNotifications_t notification){(void)notification; return true;}
+void SoundNotificationsPlayInBlockingMode(SoundNotifications_t notification){(void)notification;}
+bool ParametersSet(parameterId_t id, float value){(void)id; (void)value; return true;}
+bool MemorySaveRegisteredVariables(){return true;}
+void AltitudeSetHome(){}
+uint8_t MotorTelemetryGetFailedMotors(){return 0;}
+bool FlightControllerGetPidCycles(uint32_t* bankCycles, uint32_t* baselineCycles){(void)bankCycles; (void)baselineCycles; return false;}
+bool FlightControllerGetStickLatency(float* latency, float* maxLatency){(void)latency; (void)maxLatency; return false;}
+batteryStatus_t BatteryStatusGetStatus(){return BATTERY_OK;}
+bool BatteryStatusGetEstimate(batteryEstimate_t* estimate){(void)estimate; return false;}
+
+bool MemoryEraseInProgress(){return false;}
+void MemoryBlockErase(){world.eraseBlocked = true;}
+void MemoryUnblockErase(){world.eraseBlocked = false;}
+
+void MotorsSetAll(const float power[MOTORS_COUNT])
+{
+    memcpy(world.motorsPower, power, sizeof(world.motorsPower));
+    world.motorsStopped++;
+}
+
+bool RadioStatusGetConnectionStatus()
+{
+    return world.radioConnected;
+}
+
+float RadioStatusGetChannelData(radioChannel_t channel)
+{
+    if(!world.radioConnected)
+    {
+        return 0;
+    }
+
+    return channel == RADIO_THROTTLE_CHANNEL ? world.throttleStick : 0;
+}
@@ -0,0 +1,374 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Tests/pid/pidTest.c
+ *
+ * @brief Host test of PID behavior, anti-windup, D on measurement, feed-forward
+ *        and D low pass, PID bank against single PIDs, equal outputs and timing
+ *        against single PIDs and original heap handle PIDs, cycle count on target
+ *        is reported by flight controller at disarm
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/pid/pid.h"
+#include "middleware/pid/pidBaseline.h"
+#include "drivers/utils/utils.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define STEPS (3000U)
+#define BENCHMARK_STEPS (2000000U)
+#define DT (0.001f)                 ///< [s] mahony loop period
+#define PI (3.14159265f)
+
+#define CHECK(condition) \
+    do{ \
+        if(!(condition)) \
+        { \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            return false; \
+        } \
+    }while(0)
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+static const pidGains_t gainsXY = {.p = 0.5f, .i = 1.0f, .d = 0.05f, .ff = 0.02f, .filterCoefficient = 70.0f,
+                                   .integralLimit = 0.05f, .outputLimit = 0.1f, .trackingGain = 10.0f};
+static const pidGains_t gainsZ = {.p = 0.3f, .i = 0.5f, .d = 0.0f, .ff = 0.0f, .filterCoefficient = 0.0f,
+                                  .integralLimit = 0.05f, .outputLimit = 0.1f, .trackingGain = 10.0f};
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief setpoint of axis at given step, steps, ramps and sine
+ *
+ * @param [in] axis
+ * @param [in] step
+ * @return setpoint
+ */
+static float Setpoint(uint32_t axis, uint32_t step);
+
+/**@brief getter for monotonic time
+ *
+ * @return [ns]
+ */
+static double NowNs();
+
+/**@brief runs saturated PID and reverses error
+ *
+ * @param [in] trackingGain - back-calculation gain
+ * @return steps after error reversal until output changes sign, STEPS if it does not
+ */
+static uint32_t StepsToRecover(float trackingGain);
+
+/**@brief drives D term alone with sine measurement
+ *
+ * @param [in] frequency - [rad/s]
+ * @return steady state D output amplitude divided by amplitude of unfiltered measurement rate
+ */
+static float DerivativeGain(float frequency);
+
+static bool TestAntiWindupRecovery();
+static bool TestNoDerivativeKick();
+static bool TestFeedForward();
+static bool TestDerivativeLowPass();
+static bool TestBankEqualsSinglePids();
+static bool TestBenchmark();
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+/** original PID measures its own sample time, DWT read is replaced by constant period **/
+float GetTimeElapsed(uint32_t* lastTimeCalled, bool setCurrentTime)
+{
+    (void)lastTimeCalled;
+    (void)setCurrentTime;
+
+    return DT;
+}
+
+int main()
+{
+    struct{
+        const char* name;
+        bool (*test)();
+    }tests[] = {
+        {"anti-windup recovery after saturation", &TestAntiWindupRecovery},
+        {"no derivative kick on setpoint step", &TestNoDerivativeKick},
+        {"feed-forward of setpoint rate", &TestFeedForward},
+        {"derivative low pass cut-off", &TestDerivativeLowPass},
+        {"bank equals single pids", &TestBankEqualsSinglePids},
+        {"benchmark", &TestBenchmark},
+    };
+
+    int failed = 0;
+    for(unsigned i=0; i<sizeof(tests)/sizeof(tests[0]); i++)
+    {
+        bool passed = tests[i].test();
+        printf("%s %s\n", passed ? "PASS" : "FAIL", tests[i].name);
+        failed += passed ? 0 : 1;
+    }
+
+    return failed;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static float Setpoint(uint32_t axis, uint32_t step)
+{
+    switch(axis)
+    {
+    case PID_BANK_X:
+        return step > 100 ? 0.3f : 0.0f;
+    case PID_BANK_Y:
+        return 0.2f*sinf((float)step*0.01f);
+    default:
+        return step > 500 ? -0.4f : 0.1f;
+    }
+}
+
+static double NowNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec*1e9 + (double)now.tv_nsec;
+}
+
+static uint32_t StepsToRecover(float trackingGain)
+{
+    const pidGains_t gains = {.p = 0.5f, .i = 2.0f, .integralLimit = 1.0f, .outputLimit = 0.2f,
+                              .trackingGain = trackingGain};
+    pidController_t pid;
+    PidInit(&pid, &gains);
+
+    /** 2s with error far above what output limit can correct, e.g. motor at max **/
+    for(uint32_t step=0; step<2000U; step++)
+    {
+        PidCalc(&pid, 1.0f, 0.0f, DT);
+    }
+
+    for(uint32_t step=0; step<STEPS; step++)
+    {
+        if(PidCalc(&pid, -0.1f, 0.0f, DT) < 0)
+        {
+            return step;
+        }
+    }
+
+    return STEPS;
+}
+
+static float DerivativeGain(float frequency)
+{
+    const pidGains_t gains = {.d = 1.0f, .filterCoefficient = 70.0f, .outputLimit = 100.0f};
+    const float amplitude = 0.01f;
+    pidController_t pid;
+    PidInit(&pid, &gains);
+
+    /** settle for 10 time constants and whole number of periods, then take peak of 1 period **/
+    uint32_t period = (uint32_t)(2.0f*PI/(frequency*DT)+0.5f);
+    uint32_t settle = ((uint32_t)(10.0f/(gains.filterCoefficient*DT))/period + 1U)*period;
+    float peak = 0;
+    for(uint32_t step=0; step<settle+period; step++)
+    {
+        float output = PidCalc(&pid, 0, amplitude*sinf(frequency*DT*(float)step), DT);
+        if(step >= settle && fabsf(output) > peak)
+        {
+            peak = fabsf(output);
+        }
+    }
+
+    return peak/(amplitude*frequency);
+}
+
+static bool TestAntiWindupRecovery()
+{
+    /** I term clamped at integralLimit keeps output saturated for integralLimit/(i*e) = 4s,
+     *  back-calculation keeps it small and output follows error reversal at once **/
+    uint32_t windup = StepsToRecover(0.0f);
+    uint32_t tracking = StepsToRecover(10.0f);
+    printf("  output reversed after %ums with tracking, %s without\n", tracking,
+           windup >= STEPS ? "not within 3s" : "earlier");
+
+    CHECK(windup >= STEPS);
+    CHECK(tracking < 20U);
+
+    return true;
+}
+
+static bool TestNoDerivativeKick()
+{
+    const pidGains_t gains = {.p = 0.5f, .d = 0.05f, .outputLimit = 100.0f};
+    pidController_t pid;
+    PidInit(&pid, &gains);
+
+    for(uint32_t step=0; step<10U; step++)
+    {
+        PidCalc(&pid, 0.0f, 0.1f, DT);
+    }
+
+    /** setpoint step gives only P response, D of setpoint would add 0.05*0.3/0.001 = 15 **/
+    float output = PidCalc(&pid, 0.3f, 0.1f, DT);
+    CHECK(fabsf(output-0.5f*0.2f) < 1e-6f);
+
+    /** the same step of measurement is damped by D **/
+    output = PidCalc(&pid, 0.3f, 0.4f, DT);
+    CHECK(fabsf(output-(-0.5f*0.1f - 0.05f*0.3f/DT)) < 1e-3f);
+
+    return true;
+}
+
+static bool TestFeedForward()
+{
+    const pidGains_t gains = {.ff = 0.02f, .outputLimit = 100.0f};
+    const float rate = 2.0f;    ///< [rad/s] setpoint ramp
+    pidController_t pid;
+    PidInit(&pid, &gains);
+
+    /** first sample has no rate, then output is ff*rate also with perfect tracking **/
+    float setpoint = 0;
+    CHECK(PidCalc(&pid, setpoint, setpoint, DT) == 0);
+    for(uint32_t step=0; step<100U; step++)
+    {
+        setpoint += rate*DT;
+        float output = PidCalc(&pid, setpoint, setpoint, DT);
+        CHECK(fabsf(output-gains.ff*rate) < 1e-4f);
+    }
+
+    /** constant setpoint, feed-forward drops to 0 **/
+    CHECK(fabsf(PidCalc(&pid, setpoint, setpoint, DT)) < 1e-6f);
+
+    return true;
+}
+
+static bool TestDerivativeLowPass()
+{
+    /** N/(s+N) with N = 70rad/s: unity well below, -3dB at N, -20dB/dec above **/
+    float low = DerivativeGain(7.0f);
+    float cutoff = DerivativeGain(70.0f);
+    float high = DerivativeGain(700.0f);
+    printf("  D gain at N/10 %.3f, N %.3f, 10N %.3f\n", low, cutoff, high);
+
+    CHECK(low > 0.98f);
+    CHECK(fabsf(cutoff-0.7071f) < 0.03f);
+    CHECK(high < 0.12f);
+
+    return true;
+}
+
+static bool TestBankEqualsSinglePids()
+{
+    pidController_t single[PID_BANK_AXES];
+    pidBank_t bank;
+
+    if(!PidBankInit(&bank, &gainsXY) || !PidBankSetGains(&bank, PID_BANK_Z, &gainsZ))
+    {
+        return false;
+    }
+    for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+    {
+        if(!PidInit(&single[axis], axis == PID_BANK_Z ? &gainsZ : &gainsXY))
+        {
+            return false;
+        }
+    }
+
+    /** integrator plant per axis, varying dt as with radio frame driven loop **/
+    float measurement[PID_BANK_AXES] = {0};
+    for(uint32_t step=0; step<STEPS; step++)
+    {
+        float dt = 0.001f*(float)(1+step%3);
+        float setpoint[PID_BANK_AXES];
+        float output[PID_BANK_AXES];
+
+        for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+        {
+            setpoint[axis] = Setpoint(axis, step);
+        }
+
+        PidBankCalc(&bank, setpoint, measurement, dt, output);
+
+        for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+        {
+            float expected = PidCalc(&single[axis], setpoint[axis], measurement[axis], dt);
+            if(expected != output[axis])
+            {
+                printf("  step %u axis %u: bank %g, single %g\n", step, axis, output[axis], expected);
+                return false;
+            }
+            measurement[axis] += expected*5.0f*dt;
+        }
+    }
+
+    return true;
+}
+
+static bool TestBenchmark()
+{
+    pidController_t single[PID_BANK_AXES];
+    pidBaselineHandle_t baseline[PID_BANK_AXES];
+    pidBank_t bank;
+    PidBankInit(&bank, &gainsXY);
+    for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+    {
+        PidInit(&single[axis], &gainsXY);
+        CHECK(PidBaselineInit(&baseline[axis], gainsXY.p, gainsXY.i, gainsXY.d, gainsXY.filterCoefficient));
+    }
+
+    volatile float sink = 0;
+    float setpoint[PID_BANK_AXES] = {0.1f, -0.1f, 0.05f};
+    float measurement[PID_BANK_AXES] = {0};
+    float output[PID_BANK_AXES];
+
+    double start = NowNs();
+    for(uint32_t step=0; step<BENCHMARK_STEPS; step++)
+    {
+        measurement[step%PID_BANK_AXES] += 1e-6f;
+        PidBankCalc(&bank, setpoint, measurement, 0.001f, output);
+        sink += output[0];
+    }
+    double bankNs = (NowNs()-start)/BENCHMARK_STEPS;
+
+    start = NowNs();
+    for(uint32_t step=0; step<BENCHMARK_STEPS; step++)
+    {
+        measurement[step%PID_BANK_AXES] += 1e-6f;
+        for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+        {
+            output[axis] = PidCalc(&single[axis], setpoint[axis], measurement[axis], 0.001f);
+        }
+        sink += output[0];
+    }
+    double singleNs = (NowNs()-start)/BENCHMARK_STEPS;
+
+    start = NowNs();
+    for(uint32_t step=0; step<BENCHMARK_STEPS; step++)
+    {
+        measurement[step%PID_BANK_AXES] += 1e-6f;
+        for(uint32_t axis=0; axis<PID_BANK_AXES; axis++)
+        {
+            output[axis] = PidBaselineCalc(baseline[axis], setpoint[axis]-measurement[axis]);
+        }
+        sink += output[0];
+    }
+    double baselineNs = (NowNs()-start)/BENCHMARK_STEPS;
+
+    printf("  host: bank %.1f ns, three single pids %.1f ns, three original pids %.1f ns per iteration\n",
+           bankNs, singleNs, baselineNs);
+
+    return sink == sink;
+}
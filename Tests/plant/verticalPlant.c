@@ -0,0 +1,52 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Tests/plant/verticalPlant.c
+ *
+ * @brief Vertical motion model of aircraft for host tests of landing
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "plant/verticalPlant.h"
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define PLANT_PERIOD (0.001f)       ///< [s] plant integration step
+#define GRAVITY (9.81f)             ///< [m/s^2]
+#define PLANT_DRAG (0.3f)           ///< [1/s] vertical velocity damping
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+void VerticalPlantStep(verticalPlant_t* plant, float throttle, float period)
+{
+    plant->peakAcceleration = 0;
+
+    for(float t=0; t<period; t+=PLANT_PERIOD)
+    {
+        float acceleration = GRAVITY*(throttle/PLANT_HOVER_THROTTLE-1.0f) - PLANT_DRAG*plant->climbRate;
+        plant->climbRate += acceleration*PLANT_PERIOD;
+        plant->altitude += plant->climbRate*PLANT_PERIOD;
+
+        if(plant->altitude <= 0 && plant->climbRate <= 0)
+        {
+            /** ground stops aircraft within one plant step **/
+            acceleration = -plant->climbRate/PLANT_PERIOD;
+            if(!plant->onGround)
+            {
+                plant->touchdownSpeed = -plant->climbRate;
+                plant->onGround = true;
+            }
+            plant->altitude = 0;
+            plant->climbRate = 0;
+        }
+
+        if(acceleration > plant->peakAcceleration)
+        {
+            plant->peakAcceleration = acceleration;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Tests/plant/verticalPlant.h
+ *
+ * @brief Vertical motion model of aircraft for host tests of landing
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+
+/*****************************************************************************
+                       PUBLIC DEFINES / MACROS / ENUMS
+*****************************************************************************/
+
+#define PLANT_HOVER_THROTTLE (0.45f)
+
+typedef struct{
+    float altitude;             ///< [m]
+    float climbRate;            ///< [m/s]
+    float peakAcceleration;     ///< [m/s^2] since last controller iteration
+    float touchdownSpeed;       ///< [m/s] vertical speed at first ground contact
+    bool onGround;
+}verticalPlant_t;
+
+/*****************************************************************************
+                         PUBLIC INTERFACE DECLARATION
+*****************************************************************************/
+
+/**@brief advances plant by one controller iteration with constant throttle
+ *
+ * @param [in/out] plant
+ * @param [in] throttle - 0..1
+ * @param [in] period - [s] controller iteration
+ */
+void VerticalPlantStep(verticalPlant_t* plant, float throttle, float period);
@@ -0,0 +1,302 @@
+/*****************************************************************************
+ * @file /CalmarFlightController/Tests/rcProtocol/rcProtocolTest.c
+ *
+ * @brief Host test of SBUS and CRSF decoder fed with receiver byte streams,
+ *        DMA chunks are emulated by feeding streams in parts with line idle only at the end
+ *
+ * @author Michal Frankiewicz
+ * @date Oct 19, 2026
+ ****************************************************************************/
+
+#include "middleware/rcProtocol/rcProtocol.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/*****************************************************************************
+                          PRIVATE DEFINES / MACROS
+*****************************************************************************/
+
+#define MAX_DECODED_FRAMES (4U)
+
+#define CHECK(condition) \
+    do{ \
+        if(!(condition)) \
+        { \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            return false; \
+        } \
+    }while(0)
+
+#define ARRAY_SIZE(array) (sizeof(array)/sizeof(array[0]))
+
+/*****************************************************************************
+                     PRIVATE STRUCTS / ENUMS / VARIABLES
+*****************************************************************************/
+
+/** SBUS frame, channels: 172, 992, 1811, 992, 172, 1811, 300, 500, 700, 900, 1100, 1300, 1500, 1700, 1024, 2047 **/
+static const uint8_t sbusFrame[] = {
+    0x0F, 0xAC, 0x00, 0xDF, 0xC4, 0xC1, 0xC7, 0x8A, 0x89, 0xB3, 0x84, 0x3E,
+    0xBC, 0x22, 0x1C, 0x13, 0x29, 0xCA, 0x5D, 0x52, 0x03, 0xF0, 0xFF, 0x00,
+    0x00,
+};
+
+static const uint16_t sbusChannels[RC_PROTOCOL_CHANNEL_COUNT] = {
+    172, 992, 1811, 992, 172, 1811, 300, 500, 700, 900, 1100, 1300, 1500, 1700, 1024, 2047
+};
+
+/** the same frame with frame lost flag, single lost frame does not mean failsafe **/
+static const uint8_t sbusFrameLost[] = {
+    0x0F, 0xAC, 0x00, 0xDF, 0xC4, 0xC1, 0xC7, 0x8A, 0x89, 0xB3, 0x84, 0x3E,
+    0xBC, 0x22, 0x1C, 0x13, 0x29, 0xCA, 0x5D, 0x52, 0x03, 0xF0, 0xFF, 0x04,
+    0x00,
+};
+
+/** receiver failsafe, all channels at 992 with frame lost and failsafe flags **/
+static const uint8_t sbusFailsafe[] = {
+    0x0F, 0xE0, 0x03, 0x1F, 0xF8, 0xC0, 0x07, 0x3E, 0xF0, 0x81, 0x0F, 0x7C,
+    0xE0, 0x03, 0x1F, 0xF8, 0xC0, 0x07, 0x3E, 0xF0, 0x81, 0x0F, 0x7C, 0x0C,
+    0x00,
+};
+
+/** CRSF RC_CHANNELS_PACKED to flight controller,
+ *  channels: 992, 992, 172, 992, 1811, 172, 191, 1792, 992 x 8 **/
+static const uint8_t crsfFrame[] = {
+    0xC8, 0x18, 0x16, 0xE0, 0x03, 0x1F, 0x2B, 0xC0, 0x37, 0x71, 0x56, 0xFC,
+    0x02, 0xE0, 0xE0, 0x03, 0x1F, 0xF8, 0xC0, 0x07, 0x3E, 0xF0, 0x81, 0x0F,
+    0x7C, 0x09,
+};
+
+static const uint16_t crsfChannels[RC_PROTOCOL_CHANNEL_COUNT] = {
+    992, 992, 172, 992, 1811, 172, 191, 1792, 992, 992, 992, 992, 992, 992, 992, 992
+};
+
+/** CRSF LINK_STATISTICS, valid crc but no channels **/
+static const uint8_t crsfLinkStatistics[] = {
+    0xC8, 0x0C, 0x14, 0x5A, 0x5B, 0x64, 0x0D, 0x00, 0x04, 0x01, 0x00, 0x00,
+    0x00, 0xC2,
+};
+
+/*****************************************************************************
+                         PRIVATE FUNCTION DECLARATION
+*****************************************************************************/
+
+/**@brief feeds stream in chunks the way radio uart isr does, line idle is signalled after last chunk
+ *
+ * @param [in/out] decoder
+ * @param [in] stream
+ * @param [in] size
+ * @param [in] chunkSize - bytes per DMA chunk
+ * @param [out] frames - decoded frames, up to MAX_DECODED_FRAMES
+ * @return count of decoded frames
+ */
+static uint32_t FeedStream(rcProtocolDecoder_t* decoder, const uint8_t* stream, uint32_t size, uint32_t chunkSize,
+                           rcProtocolFrame_t frames[MAX_DECODED_FRAMES]);
+
+static bool TestSbusChannels();
+static bool TestSbusFlags();
+static bool TestSbusResync();
+static bool TestCrsfChannels();
+static bool TestCrsfBadCrc();
+static bool TestCrsfOtherFrameType();
+static bool TestCrsfSplitChunks();
+static bool TestCrsfConcatenatedFrames();
+
+/*****************************************************************************
+                           INTERFACE IMPLEMENTATION
+*****************************************************************************/
+
+int main()
+{
+    struct{
+        const char* name;
+        bool (*test)();
+    }tests[] = {
+        {"sbus 16 channels", &TestSbusChannels},
+        {"sbus frame lost and failsafe flags", &TestSbusFlags},
+        {"sbus resync after garbage and bad footer", &TestSbusResync},
+        {"crsf rc channels packed", &TestCrsfChannels},
+        {"crsf bad crc rejected", &TestCrsfBadCrc},
+        {"crsf link statistics ignored", &TestCrsfOtherFrameType},
+        {"crsf frame split over dma chunks", &TestCrsfSplitChunks},
+        {"crsf frames concatenated in one chunk", &TestCrsfConcatenatedFrames},
+    };
+
+    int failed = 0;
+    for(unsigned i=0; i<sizeof(tests)/sizeof(tests[0]); i++)
+    {
+        bool passed = tests[i].test();
+        printf("%s %s\n", passed ? "PASS" : "FAIL", tests[i].name);
+        failed += passed ? 0 : 1;
+    }
+
+    return failed;
+}
+
+/******************************************************************************
+                        PRIVATE FUNCTION IMPLEMENTATION
+******************************************************************************/
+
+static uint32_t FeedStream(rcProtocolDecoder_t* decoder, const uint8_t* stream, uint32_t size, uint32_t chunkSize,
+                           rcProtocolFrame_t frames[MAX_DECODED_FRAMES])
+{
+    uint32_t count = 0;
+
+    for(uint32_t chunk=0; chunk<size; chunk+=chunkSize)
+    {
+        for(uint32_t i=chunk; i<size && i<chunk+chunkSize; i++)
+        {
+            rcProtocolFrame_t frame;
+            if(RcProtocolFeed(decoder, stream[i], &frame) && count < MAX_DECODED_FRAMES)
+            {
+                frames[count++] = frame;
+            }
+        }
+    }
+
+    RcProtocolReset(decoder);
+
+    return count;
+}
+
+static bool TestSbusChannels()
+{
+    rcProtocolDecoder_t decoder;
+    rcProtocolFrame_t frames[MAX_DECODED_FRAMES];
+    RcProtocolInit(&decoder, RC_PROTOCOL_SBUS);
+
+    CHECK(FeedStream(&decoder, sbusFrame, sizeof(sbusFrame), sizeof(sbusFrame), frames) == 1);
+    CHECK(memcmp(frames[0].channels, sbusChannels, sizeof(sbusChannels)) == 0);
+    CHECK(!frames[0].failsafe);
+
+    CHECK(RcProtocolNormalize(frames[0].channels[0]) == 0.0f);
+    CHECK(RcProtocolNormalize(frames[0].channels[2]) == 1.0f);
+
+    return true;
+}
+
+static bool TestSbusFlags()
+{
+    rcProtocolDecoder_t decoder;
+    rcProtocolFrame_t frames[MAX_DECODED_FRAMES];
+    RcProtocolInit(&decoder, RC_PROTOCOL_SBUS);
+
+    CHECK(FeedStream(&decoder, sbusFrameLost, sizeof(sbusFrameLost), sizeof(sbusFrameLost), frames) == 1);
+    CHECK(!frames[0].failsafe);
+    CHECK(memcmp(frames[0].channels, sbusChannels, sizeof(sbusChannels)) == 0);
+
+    CHECK(FeedStream(&decoder, sbusFailsafe, sizeof(sbusFailsafe), sizeof(sbusFailsafe), frames) == 1);
+    CHECK(frames[0].failsafe);
+
+    return true;
+}
+
+static bool TestSbusResync()
+{
+    rcProtocolDecoder_t decoder;
+    rcProtocolFrame_t frames[MAX_DECODED_FRAMES];
+    RcProtocolInit(&decoder, RC_PROTOCOL_SBUS);
+
+    /** tail of previous frame received after power up is dropped until header **/
+    uint8_t stream[3+sizeof(sbusFrame)] = {0x7C, 0x00, 0x00};
+    memcpy(&stream[3], sbusFrame, sizeof(sbusFrame));
+    CHECK(FeedStream(&decoder, stream, sizeof(stream), 8, frames) == 1);
+    CHECK(memcmp(frames[0].channels, sbusChannels, sizeof(sbusChannels)) == 0);
+
+    uint8_t badFooter[sizeof(sbusFrame)];
+    memcpy(badFooter, sbusFrame, sizeof(sbusFrame));
+    badFooter[sizeof(badFooter)-1] = 0x0F;
+    CHECK(FeedStream(&decoder, badFooter, sizeof(badFooter), sizeof(badFooter), frames) == 0);
+
+    /** frame torn by line idle is dropped, next one decodes **/
+    CHECK(FeedStream(&decoder, sbusFrame, 10, 10, frames) == 0);
+    CHECK(FeedStream(&decoder, sbusFrame, sizeof(sbusFrame), sizeof(sbusFrame), frames) == 1);
+
+    return true;
+}
+
+static bool TestCrsfChannels()
+{
+    rcProtocolDecoder_t decoder;
+    rcProtocolFrame_t frames[MAX_DECODED_FRAMES];
+    RcProtocolInit(&decoder, RC_PROTOCOL_CRSF);
+
+    CHECK(FeedStream(&decoder, crsfFrame, sizeof(crsfFrame), sizeof(crsfFrame), frames) == 1);
+    CHECK(memcmp(frames[0].channels, crsfChannels, sizeof(crsfChannels)) == 0);
+    CHECK(!frames[0].failsafe);
+
+    CHECK(RcProtocolNormalize(frames[0].channels[6]) == 0.0f);
+    CHECK(RcProtocolNormalize(frames[0].channels[7]) == 1.0f);
+
+    return true;
+}
+
+static bool TestCrsfBadCrc()
+{
+    rcProtocolDecoder_t decoder;
+    rcProtocolFrame_t frames[MAX_DECODED_FRAMES];
+    RcProtocolInit(&decoder, RC_PROTOCOL_CRSF);
+
+    uint8_t corrupted[sizeof(crsfFrame)];
+    memcpy(corrupted, crsfFrame, sizeof(crsfFrame));
+    corrupted[10] ^= 0x01;
+    CHECK(FeedStream(&decoder, corrupted, sizeof(corrupted), sizeof(corrupted), frames) == 0);
+
+    memcpy(corrupted, crsfFrame, sizeof(crsfFrame));
+    corrupted[sizeof(corrupted)-1] ^= 0x80;
+    CHECK(FeedStream(&decoder, corrupted, sizeof(corrupted), sizeof(corrupted), frames) == 0);
+
+    CHECK(FeedStream(&decoder, crsfFrame, sizeof(crsfFrame), sizeof(crsfFrame), frames) == 1);
+
+    return true;
+}
+
+static bool TestCrsfOtherFrameType()
+{
+    rcProtocolDecoder_t decoder;
+    rcProtocolFrame_t frames[MAX_DECODED_FRAMES];
+    RcProtocolInit(&decoder, RC_PROTOCOL_CRSF);
+
+    CHECK(FeedStream(&decoder, crsfLinkStatistics, sizeof(crsfLinkStatistics), sizeof(crsfLinkStatistics), frames) == 0);
+
+    return true;
+}
+
+static bool TestCrsfSplitChunks()
+{
+    rcProtocolDecoder_t decoder;
+    rcProtocolFrame_t frames[MAX_DECODED_FRAMES];
+    RcProtocolInit(&decoder, RC_PROTOCOL_CRSF);
+
+    /** half transfer interrupts hand over frame in parts without line idle in between **/
+    for(uint32_t chunkSize=1; chunkSize<sizeof(crsfFrame); chunkSize++)
+    {
+        CHECK(FeedStream(&decoder, crsfFrame, sizeof(crsfFrame), chunkSize, frames) == 1);
+        CHECK(memcmp(frames[0].channels, crsfChannels, sizeof(crsfChannels)) == 0);
+    }
+
+    return true;
+}
+
+static bool TestCrsfConcatenatedFrames()
+{
+    rcProtocolDecoder_t decoder;
+    rcProtocolFrame_t frames[MAX_DECODED_FRAMES];
+    RcProtocolInit(&decoder, RC_PROTOCOL_CRSF);
+
+    /** telemetry and two channel frames back to back, as received in one DMA chunk **/
+    uint8_t stream[sizeof(crsfLinkStatistics)+2*sizeof(crsfFrame)];
+    memcpy(stream, crsfFrame, sizeof(crsfFrame));
+    memcpy(&stream[sizeof(crsfFrame)], crsfLinkStatistics, sizeof(crsfLinkStatistics));
+    memcpy(&stream[sizeof(crsfFrame)+sizeof(crsfLinkStatistics)], crsfFrame, sizeof(crsfFrame));
+
+    CHECK(FeedStream(&decoder, stream, sizeof(stream), sizeof(stream), frames) == 2);
+    CHECK(memcmp(frames[0].channels, crsfChannels, sizeof(crsfChannels)) == 0);
+    CHECK(memcmp(frames[1].channels, crsfChannels, sizeof(crsfChannels)) == 0);
+
+    /** the same stream split at odd positions **/
+    CHECK(FeedStream(&decoder, stream, sizeof(stream), 7, frames) == 2);
+
+    return true;
+}
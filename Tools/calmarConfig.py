@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""Host side of the flight controller configuration protocol.
+
+Talks to Core/middleware/configProtocol over the debug uart (USART1, 1 Mbaud).
+Debug text printed by the controller is skipped while waiting for responses.
+
+    calmarConfig.py -p /dev/ttyUSB0 list
+    calmarConfig.py -p /dev/ttyUSB0 get PID_XY_P PID_XY_D
+    calmarConfig.py -p /dev/ttyUSB0 set PID_XY_P=0.12 PID_XY_D=0.025 --save
+    calmarConfig.py -p /dev/ttyUSB0 save
+
+Requires pyserial.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import serial
+
+SYNC = 0xC5
+RESPONSE = 0x80
+MAX_PAYLOAD = 240
+PROTOCOL_VERSION = 2
+
+CMD_INFO = 0x01
+CMD_DESCRIBE = 0x02
+CMD_GET = 0x03
+CMD_SET = 0x04
+CMD_SAVE = 0x05
+
+STATUS = {
+    0: "ok",
+    1: "unknown command",
+    2: "invalid length",
+    3: "invalid parameter id",
+    4: "busy, disarm first or change only live parameters",
+    5: "save failed",
+}
+
+TYPES = {0: "float", 1: "int32"}
+
+FLAG_LIVE = 0x01
+
+MAX_GET_ITEMS = (MAX_PAYLOAD - 1) // 4
+MAX_SET_ITEMS = MAX_PAYLOAD // 5
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0xD5) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+class ProtocolError(Exception):
+    pass
+
+
+class Connection:
+    def __init__(self, port, baudrate, timeout, retries):
+        self.serial = serial.Serial(port, baudrate, timeout=0.01)
+        self.timeout = timeout
+        self.retries = retries
+
+    def request(self, command, payload=b""):
+        body = bytes([command, len(payload)]) + payload
+        frame = bytes([SYNC]) + body + bytes([crc8(body)])
+
+        for _ in range(self.retries + 1):
+            self.serial.reset_input_buffer()
+            self.serial.write(frame)
+            response = self._read_response(command | RESPONSE)
+            if response is not None:
+                status, data = response[0], response[1:]
+                if status != 0:
+                    raise ProtocolError(STATUS.get(status, "status %d" % status))
+                return data
+        raise ProtocolError("no response")
+
+    def _read_response(self, command):
+        deadline = time.monotonic() + self.timeout
+        buffer = bytearray()
+        while time.monotonic() < deadline:
+            buffer += self.serial.read(256)
+            while True:
+                start = buffer.find(bytes([SYNC, command]))
+                if start < 0 or len(buffer) < start + 3:
+                    break
+                length = buffer[start + 2]
+                end = start + 3 + length
+                if len(buffer) < end + 1:
+                    break
+                if length > 0 and crc8(buffer[start + 1:end]) == buffer[end]:
+                    return bytes(buffer[start + 3:end])
+                del buffer[:start + 1]
+        return None
+
+
+def read_table(connection):
+    version, count, schema = struct.unpack("<BBI", connection.request(CMD_INFO))
+    if version != PROTOCOL_VERSION:
+        raise ProtocolError("unsupported protocol version %d" % version)
+
+    table = []
+    for parameter_id in range(count):
+        data = connection.request(CMD_DESCRIBE, bytes([parameter_id]))
+        _, type_id, key, flags, default, minimum, maximum, scale = struct.unpack("<BBBBffff", data[:20])
+        table.append({
+            "id": parameter_id,
+            "name": data[20:].decode("ascii"),
+            "type": TYPES.get(type_id, str(type_id)),
+            "key": key,
+            "live": bool(flags & FLAG_LIVE),
+            "default": default,
+            "min": minimum,
+            "max": maximum,
+            "scale": scale,
+        })
+    return schema, table
+
+
+def get_values(connection, ids):
+    values = []
+    for i in range(0, len(ids), MAX_GET_ITEMS):
+        chunk = ids[i:i + MAX_GET_ITEMS]
+        data = connection.request(CMD_GET, bytes(chunk))
+        values += struct.unpack("<%df" % len(chunk), data)
+    return values
+
+
+def set_values(connection, items):
+    applied = []
+    for i in range(0, len(items), MAX_SET_ITEMS):
+        chunk = items[i:i + MAX_SET_ITEMS]
+        payload = b"".join(struct.pack("<Bf", parameter_id, value) for parameter_id, value in chunk)
+        data = connection.request(CMD_SET, payload)
+        applied += struct.unpack("<%df" % len(chunk), data)
+    return applied
+
+
+def find(table, name):
+    for entry in table:
+        if entry["name"] == name.upper():
+            return entry
+    raise ProtocolError("unknown parameter %s" % name)
+
+
+def command_list(connection, args):
+    schema, table = read_table(connection)
+    values = get_values(connection, [entry["id"] for entry in table])
+    print("schema 0x%08x, %d parameters" % (schema, len(table)))
+    for entry, value in zip(table, values):
+        persistent = "key %2d" % entry["key"] if entry["key"] else "ram   "
+        live = ", live" if entry["live"] else ""
+        print("%-16s %12g  [%g .. %g] default %g, %s, %s%s" % (
+            entry["name"], value, entry["min"], entry["max"], entry["default"], entry["type"], persistent, live))
+
+
+def command_get(connection, args):
+    _, table = read_table(connection)
+    entries = [find(table, name) for name in args.names]
+    for entry, value in zip(entries, get_values(connection, [entry["id"] for entry in entries])):
+        print("%s=%g" % (entry["name"], value))
+
+
+def command_set(connection, args):
+    _, table = read_table(connection)
+    items = []
+    for assignment in args.assignments:
+        name, _, value = assignment.partition("=")
+        items.append((find(table, name)["id"], float(value)))
+
+    applied = set_values(connection, items)
+    for (parameter_id, requested), value in zip(items, applied):
+        clamped = " (clamped)" if value != struct.unpack("<f", struct.pack("<f", requested))[0] else ""
+        print("%s=%g%s" % (table[parameter_id]["name"], value, clamped))
+
+    if args.save:
+        connection.request(CMD_SAVE)
+        print("saved")
+
+
+def command_save(connection, args):
+    connection.request(CMD_SAVE)
+    print("saved")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-p", "--port", required=True)
+    parser.add_argument("-b", "--baudrate", type=int, default=1000000)
+    parser.add_argument("-t", "--timeout", type=float, default=0.2, help="response timeout [s]")
+    parser.add_argument("-r", "--retries", type=int, default=2)
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    commands.add_parser("list", help="print all parameters").set_defaults(handler=command_list)
+
+    get_parser = commands.add_parser("get", help="read parameters")
+    get_parser.add_argument("names", nargs="+")
+    get_parser.set_defaults(handler=command_get)
+
+    set_parser = commands.add_parser("set", help="write parameters, NAME=VALUE")
+    set_parser.add_argument("assignments", nargs="+")
+    set_parser.add_argument("-s", "--save", action="store_true", help="store in flash afterwards")
+    set_parser.set_defaults(handler=command_set)
+
+    commands.add_parser("save", help="store parameters in flash").set_defaults(handler=command_save)
+
+    args = parser.parse_args()
+    connection = Connection(args.port, args.baudrate, args.timeout, args.retries)
+    try:
+        args.handler(connection, args)
+    except ProtocolError as error:
+        print("error: %s" % error, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())